@@ -166,9 +166,10 @@ class Adafruit_GFX : public Stream
     inline void setTextWrap(bool w) { wrap = w; };
 
     /// Set the display rotation, 1, 2, 3, or 4
-    void setRotation(uint8_t r);
+    // virtual so display drivers can resolve their pixel transform once per rotation change
+    virtual void setRotation(uint8_t r);
     /// Get the current rotation
-    inline uint8_t getRotation(void) { rotation %= 4; return rotation; };
+    inline uint8_t getRotation(void) { return rotation; }; // always 0 - 3, see setRotation()
 
 protected:
     int16_t  _rawWidth, _rawHeight;   // this is the 'raw' display w/h - never changes
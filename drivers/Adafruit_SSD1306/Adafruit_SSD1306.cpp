@@ -44,6 +44,8 @@ All text above, and the splash screen below must be included in any redistributi
 #define SSD1306_COMSCANDEC 0xC8
 #define SSD1306_SEGREMAP 0xA0
 #define SSD1306_CHARGEPUMP 0x8D
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
 
 void Adafruit_SSD1306::begin(uint8_t vccstate)
 {
@@ -58,75 +60,199 @@ void Adafruit_SSD1306::begin(uint8_t vccstate)
     rst = 1;
     // turn on VCC (9V?)
 
-    command(SSD1306_DISPLAYOFF);
-    command(SSD1306_SETDISPLAYCLOCKDIV);
-    command(0x80);                                  // the suggested ratio 0x80
+    // sent as a single command list
+    const uint8_t init[] =
+    {
+        SSD1306_DISPLAYOFF,
+        SSD1306_SETDISPLAYCLOCKDIV,
+        0x80,                                       // the suggested ratio 0x80
+
+        SSD1306_SETMULTIPLEX,
+        (uint8_t)(_rawHeight-1),
 
-    command(SSD1306_SETMULTIPLEX);
-    command(_rawHeight-1);
+        SSD1306_SETDISPLAYOFFSET,
+        0x0,                                        // no offset
 
-    command(SSD1306_SETDISPLAYOFFSET);
-    command(0x0);                                   // no offset
+        SSD1306_SETSTARTLINE | 0x0,                 // line #0
 
-    command(SSD1306_SETSTARTLINE | 0x0);            // line #0
+        SSD1306_CHARGEPUMP,
+        (uint8_t)((vccstate == SSD1306_EXTERNALVCC) ? 0x10 : 0x14),
 
-    command(SSD1306_CHARGEPUMP);
-    command((vccstate == SSD1306_EXTERNALVCC) ? 0x10 : 0x14);
+        SSD1306_MEMORYMODE,
+        0x00,                                       // 0x0 act like ks0108
 
-    command(SSD1306_MEMORYMODE);
-    command(0x00);                                  // 0x0 act like ks0108
+        SSD1306_SEGREMAP | 0x1,
 
-    command(SSD1306_SEGREMAP | 0x1);
+        SSD1306_COMSCANDEC,
 
-    command(SSD1306_COMSCANDEC);
+        SSD1306_SETCOMPINS,
+        (uint8_t)(_rawHeight == 32 ? 0x02 : 0x12),  // TODO - calculate based on _rawHieght ?
 
-    command(SSD1306_SETCOMPINS);
-    command(_rawHeight == 32 ? 0x02 : 0x12);        // TODO - calculate based on _rawHieght ?
+        SSD1306_SETCONTRAST,
+        (uint8_t)(_rawHeight == 32 ? 0x8F : ((vccstate == SSD1306_EXTERNALVCC) ? 0x9F : 0xCF) ),
 
-    command(SSD1306_SETCONTRAST);
-    command(_rawHeight == 32 ? 0x8F : ((vccstate == SSD1306_EXTERNALVCC) ? 0x9F : 0xCF) );
+        SSD1306_SETPRECHARGE,
+        (uint8_t)((vccstate == SSD1306_EXTERNALVCC) ? 0x22 : 0xF1),
 
-    command(SSD1306_SETPRECHARGE);
-    command((vccstate == SSD1306_EXTERNALVCC) ? 0x22 : 0xF1);
+        SSD1306_SETVCOMDETECT,
+        0x40,
 
-    command(SSD1306_SETVCOMDETECT);
-    command(0x40);
+        SSD1306_DISPLAYALLON_RESUME,
 
-    command(SSD1306_DISPLAYALLON_RESUME);
+        SSD1306_NORMALDISPLAY,
 
-    command(SSD1306_NORMALDISPLAY);
-    
-    command(SSD1306_DISPLAYON);
+        SSD1306_DISPLAYON
+    };
+    commandList(init, sizeof(init));
 }
 
 // Set a single pixel
 void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
 {
-    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    (this->*pixelWriter)(x, y, color);
+}
+
+void Adafruit_SSD1306::setRotation(uint8_t r)
+{
+    Adafruit_GFX::setRotation(r);
+
+    // 128x32 and 128x64 get the geometry folded in at compile time, anything else uses the generic writer
+    if (_rawWidth == 128 && _rawHeight == 32)
+        pixelWriter = pixelWriterFor<128, 32>(rotation);
+    else if (_rawWidth == 128 && _rawHeight == 64)
+        pixelWriter = pixelWriterFor<128, 64>(rotation);
+    else
+        pixelWriter = pixelWriterFor<0, 0>(rotation);
+}
+
+template <int16_t RAW_WIDTH, int16_t RAW_HEIGHT>
+Adafruit_SSD1306::PixelWriter Adafruit_SSD1306::pixelWriterFor(uint8_t rotation)
+{
+    switch (rotation)
+    {
+        case 1: return &Adafruit_SSD1306::writePixel<1, RAW_WIDTH, RAW_HEIGHT>;
+        case 2: return &Adafruit_SSD1306::writePixel<2, RAW_WIDTH, RAW_HEIGHT>;
+        case 3: return &Adafruit_SSD1306::writePixel<3, RAW_WIDTH, RAW_HEIGHT>;
+        default: return &Adafruit_SSD1306::writePixel<0, RAW_WIDTH, RAW_HEIGHT>;
+    }
+}
+
+// RAW_WIDTH / RAW_HEIGHT of 0 == take the size from _rawWidth / _rawHeight at runtime
+template <uint8_t ROTATION, int16_t RAW_WIDTH, int16_t RAW_HEIGHT>
+void Adafruit_SSD1306::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    const int16_t rawWidth = RAW_WIDTH ? RAW_WIDTH : _rawWidth;
+    const int16_t rawHeight = RAW_HEIGHT ? RAW_HEIGHT : _rawHeight;
+
+    // unsigned compare covers x < 0 and y < 0 as well
+    if ((uint16_t)x >= (uint16_t)((ROTATION & 1) ? rawHeight : rawWidth) || (uint16_t)y >= (uint16_t)((ROTATION & 1) ? rawWidth : rawHeight))
         return;
-    
-    // check rotation, move pixel around if necessary
-    switch (getRotation())
+
+    // move pixel around for the rotation, resolved at compile time
+    int16_t column, row;
+    switch (ROTATION)
     {
         case 1:
-            swap(x, y);
-            x = _rawWidth - x - 1;
+            column = rawWidth - y - 1;
+            row = x;
             break;
         case 2:
-            x = _rawWidth - x - 1;
-            y = _rawHeight - y - 1;
+            column = rawWidth - x - 1;
+            row = rawHeight - y - 1;
             break;
         case 3:
-            swap(x, y);
-            y = _rawHeight - y - 1;
+            column = y;
+            row = rawHeight - x - 1;
+            break;
+        default:
+            column = x;
+            row = y;
             break;
-    }  
-    
-    // x is which column
-    if (color == WHITE) 
-        buffer[x+ (y/8)*_rawWidth] |= _BV((y%8));  
+    }
+
+    markDirty(row >> 3, column, column);
+
+    if (color == WHITE)
+        buffer[column + (row >> 3) * rawWidth] |= _BV(row & 7);
     else // else black
-        buffer[x+ (y/8)*_rawWidth] &= ~_BV((y%8)); 
+        buffer[column + (row >> 3) * rawWidth] &= ~_BV(row & 7);
+}
+
+#if defined(GFX_WANT_ABSTRACTS) || defined(GFX_SIZEABLE_TEXT)
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+// Fill a rectangle, clipped once and mapped to raw display coordinates for the current rotation
+void Adafruit_SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width()) w = width() - x;
+    if (y + h > height()) h = height() - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    switch (getRotation())
+    {
+        case 1:
+            fillRawRect(_rawWidth - y - h, x, h, w, color);
+            break;
+        case 2:
+            fillRawRect(_rawWidth - x - w, _rawHeight - y - h, w, h, color);
+            break;
+        case 3:
+            fillRawRect(y, _rawHeight - x - w, h, w, color);
+            break;
+        default:
+            fillRawRect(x, y, w, h, color);
+            break;
+    }
+}
+#endif
+
+#ifdef GFX_WANT_ABSTRACTS
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SSD1306::fillScreen(uint16_t color)
+{
+    std::fill(buffer.begin(), buffer.end(), color == WHITE ? 0xFF : 0x00);
+    invalidate();
+}
+#endif
+
+// Fill an already clipped rectangle in raw display coordinates. Each page it touches gets one mask
+// (only the first and last page can be partial) OR'd / cleared across the column run
+void Adafruit_SSD1306::fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    int16_t firstPage = y / 8;
+    int16_t lastPage = (y + h - 1) / 8;
+
+    for (int16_t page = firstPage; page <= lastPage; page++)
+    {
+        uint8_t mask = 0xFF;
+        if (page == firstPage)
+            mask &= 0xFF << (y & 7);
+        if (page == lastPage)
+            mask &= 0xFF >> (7 - ((y + h - 1) & 7));
+
+        uint8_t *column = &buffer[page * _rawWidth + x];
+        if (color == WHITE)
+        {
+            for (int16_t i = 0; i < w; i++)
+                column[i] |= mask;
+        }
+        else
+        {
+            for (int16_t i = 0; i < w; i++)
+                column[i] &= ~mask;
+        }
+        markDirty(page, x, x + w - 1);
+    }
 }
 
 void Adafruit_SSD1306::invertDisplay(bool i)
@@ -134,19 +260,162 @@ void Adafruit_SSD1306::invertDisplay(bool i)
 	command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
 }
 
-// Send the display buffer out to the display
+// Send the changed parts of the display buffer out to the display
+// Each dirty page is sent as its own column / page address window. Runs of fully dirty pages are
+// contiguous in the buffer (horizontal addressing mode), so they go out as a single window.
 void Adafruit_SSD1306::display(void)
 {
-	command(SSD1306_SETLOWCOLUMN | 0x0);  // low col = 0
-	command(SSD1306_SETHIGHCOLUMN | 0x0);  // hi col = 0
-	command(SSD1306_SETSTARTLINE | 0x0); // line #0
-	sendDisplayBuffer();
+	if (!frontBuffer.empty())
+	{
+		displayDiff();
+		return;
+	}
+
+	int16_t pages = _rawHeight / 8;
+
+	for (int16_t page = 0; page < pages; page++)
+	{
+		if (dirtyStart[page] > dirtyEnd[page])
+			continue;
+
+		uint8_t x0 = dirtyStart[page];
+		uint8_t x1 = dirtyEnd[page];
+		int16_t lastPage = page;
+		if (x0 == 0 && x1 == _rawWidth - 1)
+		{
+			while (lastPage + 1 < pages && dirtyStart[lastPage + 1] == 0 && dirtyEnd[lastPage + 1] == _rawWidth - 1)
+				lastPage++;
+		}
+
+		setWindow(x0, x1, page, lastPage);
+
+		if (lastPage == page)
+			sendDisplayData(&buffer[page * _rawWidth + x0], x1 - x0 + 1);
+		else
+			sendDisplayData(&buffer[page * _rawWidth], (lastPage - page + 1) * _rawWidth);
+
+		for (int16_t p = page; p <= lastPage; p++)
+		{
+			dirtyStart[p] = 0xFF;
+			dirtyEnd[p] = 0;
+		}
+		page = lastPage;
+	}
+}
+
+// Double buffered display(), the dirty span of each page is compared against the front buffer a 32 bit word
+// at a time, and only runs of columns that differ are sent (runs closer than SSD1306_DIFF_MAX_GAP are merged)
+void Adafruit_SSD1306::displayDiff(void)
+{
+	for (int16_t page = 0; page < _rawHeight / 8; page++)
+	{
+		if (dirtyStart[page] > dirtyEnd[page])
+			continue;
+
+		const uint8_t *back = &buffer[page * _rawWidth];
+		const uint8_t *front = &frontBuffer[page * _rawWidth];
+		int16_t runStart = -1, runEnd = -1;
+
+		for (int16_t x = dirtyStart[page] & ~3; x <= dirtyEnd[page]; x += 4)
+		{
+			uint32_t a, b;
+			memcpy(&a, &back[x], 4);
+			memcpy(&b, &front[x], 4);
+			if (a == b)
+				continue;
+
+			int16_t x0 = x, x1 = x + 3;
+			while (back[x0] == front[x0]) x0++;
+			while (back[x1] == front[x1]) x1--;
+
+			if (runStart >= 0 && x0 - runEnd - 1 <= SSD1306_DIFF_MAX_GAP)
+			{
+				runEnd = x1;
+			}
+			else
+			{
+				if (runStart >= 0)
+					sendRun(page, runStart, runEnd);
+				runStart = x0;
+				runEnd = x1;
+			}
+		}
+		if (runStart >= 0)
+			sendRun(page, runStart, runEnd);
+
+		dirtyStart[page] = 0xFF;
+		dirtyEnd[page] = 0;
+	}
+}
+
+void Adafruit_SSD1306::sendRun(uint8_t page, uint8_t x0, uint8_t x1)
+{
+	setWindow(x0, x1, page, page);
+	sendDisplayData(&buffer[page * _rawWidth + x0], x1 - x0 + 1);
+	std::copy(&buffer[page * _rawWidth + x0], &buffer[page * _rawWidth + x1 + 1], &frontBuffer[page * _rawWidth + x0]);
+}
+
+// Pending changes are sent first, so the front buffer starts out matching the display
+// (the display width must be a multiple of 4 for the word compare)
+void Adafruit_SSD1306::setDoubleBuffered(bool enable)
+{
+	if (enable == !frontBuffer.empty())
+		return;
+
+	if (enable)
+	{
+		display();
+		frontBuffer = buffer;
+	}
+	else
+	{
+		std::vector<uint8_t>().swap(frontBuffer);
+	}
+}
+
+// Set the column / page address window the following display data is written to
+void Adafruit_SSD1306::setWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+	const uint8_t window[] = { SSD1306_COLUMNADDR, x0, x1, SSD1306_PAGEADDR, page0, page1 };
+	commandList(window, sizeof(window));
+}
+
+// Bounding window of all dirty pages, which is then marked clean. Returns false if nothing has changed
+bool Adafruit_SSD1306::takeDirtyWindow(uint8_t &x0, uint8_t &x1, uint8_t &page0, uint8_t &page1)
+{
+	bool dirty = false;
+	x0 = 0xFF;
+	x1 = 0;
+	for (int16_t page = 0; page < _rawHeight / 8; page++)
+	{
+		if (dirtyStart[page] > dirtyEnd[page])
+			continue;
+		if (!dirty)
+			page0 = page;
+		page1 = page;
+		dirty = true;
+		x0 = std::min(x0, dirtyStart[page]);
+		x1 = std::max(x1, dirtyEnd[page]);
+		dirtyStart[page] = 0xFF;
+		dirtyEnd[page] = 0;
+	}
+	return dirty;
+}
+
+void Adafruit_SSD1306::invalidate(void)
+{
+	for (int16_t page = 0; page < SSD1306_MAX_PAGES; page++)
+	{
+		dirtyStart[page] = 0;
+		dirtyEnd[page] = _rawWidth - 1;
+	}
 }
 
 // Clear the display buffer. Requires a display() call at some point afterwards
 void Adafruit_SSD1306::clearDisplay(void)
 {
 	std::fill(buffer.begin(),buffer.end(),0);
+	invalidate();
 }
 
 void Adafruit_SSD1306::splash(void)
@@ -226,5 +495,6 @@ void Adafruit_SSD1306::splash(void)
 		, &adaFruitLogo[0] + (_rawHeight == 32 ? sizeof(adaFruitLogo)/2 : sizeof(adaFruitLogo))
 		, buffer.begin()
 		);
+	invalidate();
 #endif
 }
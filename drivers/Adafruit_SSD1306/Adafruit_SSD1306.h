@@ -42,6 +42,13 @@ public:
 #define SSD1306_EXTERNALVCC 0x1
 #define SSD1306_SWITCHCAPVCC 0x2
 
+#define SSD1306_MAX_PAGES 8	// 64 rows / 8 rows per page
+#ifndef SSD1306_I2C_CHUNK_SIZE
+#define SSD1306_I2C_CHUNK_SIZE 1024	// max display bytes per I2C transaction, 1024 == a whole 128x64 frame
+#endif
+#define SSD1306_MAX_COMMAND_LIST 32	// max command bytes per I2C command list transaction
+#define SSD1306_DIFF_MAX_GAP 8	// unchanged columns sent rather than starting a new window (6 command bytes)
+
 /** The pure base class for the SSD1306 display driver.
  *
  * You should derive from this for a new transport interface type,
@@ -55,6 +62,8 @@ public:
 		, rst(RST,false)
 	{
 		buffer.resize(rawHeight * rawWidth / 8);
+		invalidate();
+		setRotation(0);
 	};
 
 	void begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC);
@@ -62,23 +71,73 @@ public:
 	// These must be implemented in the derived transport driver
 	virtual void command(uint8_t c) = 0;
 	virtual void data(uint8_t c) = 0;
+	/// Send a sequence of command bytes, transports override this to send it as a single transfer
+	virtual void commandList(const uint8_t *c, size_t length)
+	{
+		for (size_t i = 0; i < length; i++)
+			command(c[i]);
+	};
 	virtual void drawPixel(int16_t x, int16_t y, uint16_t color);
+	virtual void setRotation(uint8_t r);
+
+	// span primitives written straight into the page layout of the buffer, rather than pixel by pixel
+#if defined(GFX_WANT_ABSTRACTS) || defined(GFX_SIZEABLE_TEXT)
+	virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+#endif
+#ifdef GFX_WANT_ABSTRACTS
+	virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	virtual void fillScreen(uint16_t color);
+#endif
 
 	/// Clear the display buffer    
 	void clearDisplay(void);
 	virtual void invertDisplay(bool i);
 
-	/// Cause the display to be updated with the buffer content.
+	/// Cause the display to be updated with the changed (dirty) parts of the buffer content.
 	void display();
+	/// Mark the whole buffer as changed, so the next display() sends all of it.
+	void invalidate();
+	/// Keep a copy of what was last sent, display() then only sends the columns that actually differ from it.
+	void setDoubleBuffered(bool enable);
 	/// Fill the buffer with the AdaFruit splash screen.
 	virtual void splash();
     
 protected:
-	virtual void sendDisplayBuffer() = 0;
+	/// Send raw display RAM bytes, to the window set up by the last column / page address commands
+	virtual void sendDisplayData(const uint8_t *data, uint16_t length) = 0;
 	DigitalOut2 rst;
 
 	// the memory buffer for the LCD
 	std::vector<uint8_t> buffer;
+
+	// copy of the display RAM as last sent, empty unless double buffered
+	std::vector<uint8_t> frontBuffer;
+
+	// dirty column span of each page, dirtyStart > dirtyEnd == page is clean
+	uint8_t dirtyStart[SSD1306_MAX_PAGES];
+	uint8_t dirtyEnd[SSD1306_MAX_PAGES];
+
+	void fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+	// drawPixel() goes through a writer specialized for the current rotation and display size, picked by setRotation()
+	typedef void (Adafruit_SSD1306::*PixelWriter)(int16_t x, int16_t y, uint16_t color);
+	PixelWriter pixelWriter;
+
+	template <uint8_t ROTATION, int16_t RAW_WIDTH, int16_t RAW_HEIGHT>
+	void writePixel(int16_t x, int16_t y, uint16_t color);
+	template <int16_t RAW_WIDTH, int16_t RAW_HEIGHT>
+	static PixelWriter pixelWriterFor(uint8_t rotation);
+	bool takeDirtyWindow(uint8_t &x0, uint8_t &x1, uint8_t &page0, uint8_t &page1);
+	void setWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+	void displayDiff();
+	void sendRun(uint8_t page, uint8_t x0, uint8_t x1);
+
+	inline void markDirty(int16_t page, int16_t x0, int16_t x1)
+	{
+		if (x0 < dirtyStart[page]) dirtyStart[page] = x0;
+		if (x1 > dirtyEnd[page]) dirtyEnd[page] = x1;
+	};
 };
 
 
@@ -106,6 +165,10 @@ public:
 	    , dc(DC,false)
 	    , mspi(spi)
 	    {
+#if DEVICE_SPI_ASYNCH
+		    transferBusy = false;
+		    txBuffer.resize(buffer.size());
+#endif
 		    begin();
 		    splash();
 		    display();
@@ -113,6 +176,7 @@ public:
 
 	virtual void command(uint8_t c)
 	{
+	    waitForTransfer();
 	    cs = 1;
 	    dc = 0;
 	    cs = 0;
@@ -120,8 +184,20 @@ public:
 	    cs = 1;
 	};
 
+	virtual void commandList(const uint8_t *c, size_t length)
+	{
+	    waitForTransfer();
+	    cs = 1;
+	    dc = 0;
+	    cs = 0;
+	    for (size_t i = 0; i < length; i++)
+	        mspi.write(c[i]);
+	    cs = 1;
+	};
+
 	virtual void data(uint8_t c)
 	{
+	    waitForTransfer();
 	    cs = 1;
 	    dc = 1;
 	    cs = 0;
@@ -129,27 +205,111 @@ public:
 	    cs = 1;
 	};
 
-protected:
-	virtual void sendDisplayBuffer()
+#if DEVICE_SPI_ASYNCH
+	/** Non-blocking display() using the asynchronous SPI API
+	 *
+	 * The bounding window of all dirty pages is copied into a transmit buffer and sent in the background,
+	 * so drawing into the buffer can carry on straight away. Returns once the transfer has been started.
+	 * If the SPI peripheral refuses the transfer (ie. busy with another one), the window is sent blocking instead.
+	 * If the transfer fails part way, the window is marked dirty again for the next display.
+	 *
+	 * @param done - called from interrupt context once the transfer completes, or straight away from the
+	 *               caller's context (before displayAsync returns) when nothing is dirty
+	 */
+	void displayAsync(Callback<void()> done = NULL)
 	{
+		uint8_t x0, x1, page0, page1;
+		if (!takeDirtyWindow(x0, x1, page0, page1))
+		{
+			if (done) done();
+			return;
+		}
+
+		setWindow(x0, x1, page0, page1); // waits for any transfer still in flight
+
+		uint16_t columns = x1 - x0 + 1;
+		uint16_t length = 0;
+		for (uint8_t page = page0; page <= page1; page++, length += columns)
+		{
+			std::copy(&buffer[page * _rawWidth + x0], &buffer[page * _rawWidth + x0] + columns, &txBuffer[length]);
+			if (!frontBuffer.empty())
+				std::copy(&buffer[page * _rawWidth + x0], &buffer[page * _rawWidth + x0] + columns, &frontBuffer[page * _rawWidth + x0]);
+		}
+
+		transferDone = done;
+		transferX0 = x0;
+		transferX1 = x1;
+		transferPage0 = page0;
+		transferPage1 = page1;
+		transferBusy = true;
 		cs = 1;
 		dc = 1;
 		cs = 0;
-
-		for(uint16_t i=0, q=buffer.size(); i<q; i++)
-			mspi.write(buffer[i]);
-
-		if(height() == 32)
+		int status = mspi.transfer(&txBuffer[0], length, (uint8_t *)NULL, 0, callback(this, &Adafruit_SSD1306_Spi::transferComplete), SPI_EVENT_COMPLETE | SPI_EVENT_ERROR);
+		if (status != 0)
 		{
-			for(uint16_t i=0, q=buffer.size(); i<q; i++)
-				mspi.write(0);
+			cs = 1;
+			transferBusy = false;
+			sendDisplayData(&txBuffer[0], length);
+			if (done) done();
 		}
+	};
+
+	/// true while an asynchronous display transfer is in flight
+	bool isBusy() { return transferBusy; };
+#endif
+
+	/// Block until an asynchronous display transfer (if any) has completed
+	void waitForTransfer()
+	{
+#if DEVICE_SPI_ASYNCH
+		while (transferBusy) {}
+#endif
+	};
+
+protected:
+	virtual void sendDisplayData(const uint8_t *data, uint16_t length)
+	{
+		waitForTransfer();
+		cs = 1;
+		dc = 1;
+		cs = 0;
+
+		for(uint16_t i=0; i<length; i++)
+			mspi.write(data[i]);
 
 		cs = 1;
 	};
 
 	DigitalOut2 cs, dc;
 	SPI &mspi;
+
+#if DEVICE_SPI_ASYNCH
+	void transferComplete(int event)
+	{
+		cs = 1;
+		if (event & SPI_EVENT_ERROR)
+		{
+			// resend the window on the next display, the front buffer no longer matches the display RAM there
+			for (uint8_t page = transferPage0; page <= transferPage1; page++)
+			{
+				markDirty(page, transferX0, transferX1);
+				if (!frontBuffer.empty())
+				{
+					for (uint16_t x = transferX0; x <= transferX1; x++)
+						frontBuffer[page * _rawWidth + x] = ~buffer[page * _rawWidth + x];
+				}
+			}
+		}
+		transferBusy = false;
+		if (transferDone) transferDone();
+	};
+
+	std::vector<uint8_t> txBuffer;	// copy of the window being sent, so the buffer can be drawn into meanwhile
+	uint8_t transferX0, transferX1, transferPage0, transferPage1;	// window of the transfer in flight
+	volatile bool transferBusy;
+	Callback<void()> transferDone;
+#endif
 };
 
 /** This is the I2C SSD1306 display driver transport class
@@ -174,7 +334,9 @@ public:
 	    : Adafruit_SSD1306(RST, rawHeight, rawWidth)
 	    , mi2c(i2c)
 	    , mi2cAddress(i2cAddress)
+	    , chunkSize(SSD1306_I2C_CHUNK_SIZE)
 	    {
+		    txBuffer.resize(std::min<size_t>(SSD1306_I2C_CHUNK_SIZE, buffer.size()) + 1);
 		    begin();
 		    splash();
 		    display();
@@ -188,6 +350,19 @@ public:
 		mi2c.write(mi2cAddress, buff, sizeof(buff));
 	}
 
+	virtual void commandList(const uint8_t *c, size_t length)
+	{
+		char buff[SSD1306_MAX_COMMAND_LIST + 1];
+		buff[0] = 0; // Command Mode, Co = 0 --> every following byte is a command
+
+		for (size_t i = 0; i < length; i += SSD1306_MAX_COMMAND_LIST)
+		{
+			size_t n = std::min<size_t>(SSD1306_MAX_COMMAND_LIST, length - i);
+			std::copy(&c[i], &c[i] + n, &buff[1]);
+			mi2c.write(mi2cAddress, buff, n + 1);
+		}
+	}
+
 	virtual void data(uint8_t c)
 	{
 		char buff[2];
@@ -196,25 +371,35 @@ public:
 		mi2c.write(mi2cAddress, buff, sizeof(buff));
 	};
 
-protected:
-	virtual void sendDisplayBuffer()
+	/** Set the max number of display bytes sent per I2C transaction
+	 *
+	 * Larger chunks save the address + control byte and start/stop of every transaction, smaller chunks
+	 * hold the bus for less time. Capped to SSD1306_I2C_CHUNK_SIZE.
+	 */
+	void setChunkSize(uint16_t size)
 	{
-		char buff[17];
-		buff[0] = 0x40; // Data Mode
+		chunkSize = std::max<uint16_t>(1, std::min<uint16_t>(size, SSD1306_I2C_CHUNK_SIZE));
+	};
 
-		// send display buffer in 16 byte chunks
-		for(uint16_t i=0, q=buffer.size(); i<q; i+=16 ) 
-		{	uint8_t x ;
+protected:
+	virtual void sendDisplayData(const uint8_t *data, uint16_t length)
+	{
+		txBuffer[0] = 0x40; // Data Mode
+		uint16_t maxChunk = std::min<size_t>(chunkSize, txBuffer.size() - 1);
 
-			// TODO - this will segfault if buffer.size() % 16 != 0
-			for(x=1; x<sizeof(buff); x++) 
-				buff[x] = buffer[i+x-1];
-			mi2c.write(mi2cAddress, buff, sizeof(buff));
+		// send display data in chunkSize transactions, the last one carries whatever is left
+		for(uint16_t i=0; i<length; i+=maxChunk) 
+		{
+			uint16_t n = std::min<uint16_t>(maxChunk, length - i);
+			std::copy(&data[i], &data[i] + n, &txBuffer[1]);
+			mi2c.write(mi2cAddress, &txBuffer[0], n + 1);
 		}
 	};
 
 	I2C &mi2c;
 	uint8_t mi2cAddress;
+	uint16_t chunkSize;
+	std::vector<char> txBuffer;	// control byte + one chunk, per instance so displays on different threads don't share it
 };
 
 #endif
\ No newline at end of file
@@ -7,10 +7,10 @@ void SX1509::init(bool extClock /*false*/) {
   int clockConfig = extClock ? 0b00100000 : 0b01010010;  // use either internal or external clock signal
   //  fOSCOUT = fOSC/(2^(RegClock[3:0]-1))
   //  ClkX = fOSC/(2^(RegMisc[6:4]-1))
-  this->i2cWrite(REG_CLOCK, clockConfig);
+  this->regWrite(REG_CLOCK, clockConfig);
+  // RegMisc bit 2 left at 0 --> register auto-increment enabled, required by every 16 bit / burst transfer
   int regMiscConfig = (DriverMode::LINEAR | ClockSpeed::EXTRA_SLOW);
-  regMiscConfig |= 0b00000100;
-  this->i2cWrite(REG_MISC, regMiscConfig); // very important for LED Driver mode that this config gets set
+  this->regWrite(REG_MISC, regMiscConfig); // LED driver clock and mode
 
   this->setDebounceTime(3); // configure a common debounce time
 }
@@ -34,6 +34,101 @@ void SX1509::pinMode(int pin, PinMode mode, bool invertPolarity /*false*/) {
   }
 }
 
+/** Bulk Pin Configuration
+ * 
+ * Takes a 16 entry pin configuration table (index == pin number) and computes the final value of every
+ * affected register from the shadow cache, without touching the bus. The registers are then written as a
+ * handful of auto-increment bursts, each trimmed down to the span of registers which actually changed:
+ * 
+ * 1. RegInputDisable -> RegDir              (ascending address order == datasheet LED driver setup order)
+ * 2. RegInterruptMask -> RegSenseLowA
+ * 3. RegLEDDriverEnable -> RegDebounceEnable
+ * 4. RegData                               (written last, setting RegData low starts the LED drivers)
+*/
+void SX1509::configurePins(const PinConfig config[16])
+{
+  uint8_t image[REG_CACHE_SIZE];
+  memcpy(image, regCache, sizeof(image));
+
+  uint16_t inputDisable = regRead16(REG_INPUT_DISABLE_B);
+  uint16_t pullup = regRead16(REG_PULL_UP_B);
+  uint16_t openDrain = regRead16(REG_OPEN_DRAIN_B);
+  uint16_t polarity = regRead16(REG_POLARITY_B);
+  uint16_t dir = regRead16(REG_DIR_B);
+  uint16_t data = regRead16(REG_DATA_B);
+  uint16_t interuptMask = regRead16(REG_INTERRUPT_MASK_B);
+  uint16_t ledDriver = regRead16(REG_LED_DRIVER_ENABLE_B);
+  uint16_t debounce = regRead16(REG_DEBOUNCE_ENABLE_B);
+  // RegSenseHighB:RegSenseLowB:RegSenseHighA:RegSenseLowA, two bits per IO (IO[x] at bits 2x+1:2x)
+  uint32_t sense = ((uint32_t)regRead16(REG_SENSE_HIGH_B) << 16) | regRead16(REG_SENSE_HIGH_A);
+
+  for (int pin = 0; pin < 16; pin++)
+  {
+    uint16_t bit = 1 << pin;
+    const PinConfig &pinConfig = config[pin];
+
+    switch (pinConfig.mode)
+    {
+    case INPUT:
+      dir |= bit;
+      inputDisable &= ~bit;
+      openDrain &= ~bit;
+      ledDriver &= ~bit;
+      pullup = pinConfig.pullup ? (pullup | bit) : (pullup & ~bit);
+      break;
+    case OUTPUT:
+      dir &= ~bit;
+      inputDisable &= ~bit;
+      openDrain &= ~bit;
+      ledDriver &= ~bit;
+      pullup = pinConfig.pullup ? (pullup | bit) : (pullup & ~bit);
+      break;
+    case ANALOG_OUTPUT:
+      dir &= ~bit;
+      inputDisable |= bit;
+      openDrain |= bit;
+      ledDriver |= bit;
+      pullup &= ~bit;
+      data &= ~bit;
+      break;
+    }
+
+    polarity = pinConfig.invertPolarity ? (polarity | bit) : (polarity & ~bit);
+    debounce = pinConfig.debounce ? (debounce | bit) : (debounce & ~bit);
+    interuptMask = (pinConfig.interupt == NONE) ? (interuptMask | bit) : (interuptMask & ~bit);
+    sense &= ~(0b11UL << (pin * 2));
+    sense |= (uint32_t)pinConfig.interupt << (pin * 2);
+  }
+
+  image[REG_INPUT_DISABLE_B] = inputDisable >> 8;
+  image[REG_INPUT_DISABLE_A] = inputDisable & 0xFF;
+  image[REG_PULL_UP_B] = pullup >> 8;
+  image[REG_PULL_UP_A] = pullup & 0xFF;
+  image[REG_OPEN_DRAIN_B] = openDrain >> 8;
+  image[REG_OPEN_DRAIN_A] = openDrain & 0xFF;
+  image[REG_POLARITY_B] = polarity >> 8;
+  image[REG_POLARITY_A] = polarity & 0xFF;
+  image[REG_DIR_B] = dir >> 8;
+  image[REG_DIR_A] = dir & 0xFF;
+  image[REG_DATA_B] = data >> 8;
+  image[REG_DATA_A] = data & 0xFF;
+  image[REG_INTERRUPT_MASK_B] = interuptMask >> 8;
+  image[REG_INTERRUPT_MASK_A] = interuptMask & 0xFF;
+  image[REG_SENSE_HIGH_B] = (sense >> 24) & 0xFF;
+  image[REG_SENSE_LOW_B] = (sense >> 16) & 0xFF;
+  image[REG_SENSE_HIGH_A] = (sense >> 8) & 0xFF;
+  image[REG_SENSE_LOW_A] = sense & 0xFF;
+  image[REG_LED_DRIVER_ENABLE_B] = ledDriver >> 8;
+  image[REG_LED_DRIVER_ENABLE_A] = ledDriver & 0xFF;
+  image[REG_DEBOUNCE_ENABLE_B] = debounce >> 8;
+  image[REG_DEBOUNCE_ENABLE_A] = debounce & 0xFF;
+
+  this->regWriteBurst(REG_INPUT_DISABLE_B, &image[REG_INPUT_DISABLE_B], REG_DIR_A - REG_INPUT_DISABLE_B + 1);
+  this->regWriteBurst(REG_INTERRUPT_MASK_B, &image[REG_INTERRUPT_MASK_B], REG_SENSE_LOW_A - REG_INTERRUPT_MASK_B + 1);
+  this->regWriteBurst(REG_LED_DRIVER_ENABLE_B, &image[REG_LED_DRIVER_ENABLE_B], REG_DEBOUNCE_ENABLE_A - REG_LED_DRIVER_ENABLE_B + 1);
+  this->regWriteBurst(REG_DATA_B, &image[REG_DATA_B], 2);
+}
+
 /**
  * Enables polarity inversion for each IO
  * 0 : Normal polarity
@@ -43,7 +138,7 @@ void SX1509::setPolarity(int pin, int polarity) {
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_POLARITY_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, polarity));
+  this->regWriteBit(reg, pinPos, polarity);
 }
 
 /**
@@ -69,41 +164,41 @@ void SX1509::setInterupt(int pin, bool willNotInterupt, InteruptDirection type)
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_INTERRUPT_MASK_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, willNotInterupt));
+  this->regWriteBit(reg, pinPos, willNotInterupt);
 
   // Set Sense
   if (pin > 7) {              // Bank B IOs
     if (pinPos > 3) {         // Bank B pins 4:7
       reg = REG_SENSE_HIGH_B;
-      hotValue = this->i2cRead(reg);
+      hotValue = this->regRead(reg);
       mask = 0b00000011 << (pinPos - 4) * 2; // shift by twos
       hotValue &= ~mask;
       hotValue |= type << (pinPos - 4) * 2;
-      this->i2cWrite(reg, hotValue);
+      this->regWrite(reg, hotValue);
     } else {                  // Bank B pins 4:7
       reg = REG_SENSE_LOW_B;
-      hotValue = this->i2cRead(reg);
+      hotValue = this->regRead(reg);
       mask = 0b00000011 << pinPos * 2; // shift by twos
       hotValue &= ~mask;
       hotValue |= type << pinPos * 2;
-      this->i2cWrite(reg, hotValue);
+      this->regWrite(reg, hotValue);
     }
   } else {
     if (pinPos > 3) { // Bank A pins 4:7
       reg = REG_SENSE_HIGH_A;
-      hotValue = this->i2cRead(reg);
+      hotValue = this->regRead(reg);
       mask = 0b00000011 << (pinPos - 4) * 2; // shift by twos
       hotValue &= ~mask;
       hotValue |= type << (pinPos - 4) * 2;
-      this->i2cWrite(reg, hotValue);
+      this->regWrite(reg, hotValue);
     }
     else { // Bank A pins 4:7
       reg = REG_SENSE_LOW_A;
-      hotValue = this->i2cRead(reg);
+      hotValue = this->regRead(reg);
       mask = 0b00000011 << pinPos * 2; // shift by twos
       hotValue &= ~mask;
       hotValue |= type << pinPos * 2;
-      this->i2cWrite(reg, hotValue);
+      this->regWrite(reg, hotValue);
     }
   }
 }
@@ -132,6 +227,277 @@ int SX1509::getInteruptSource(Bank bank)
   return this->i2cRead(REG_INTERRUPT_SOURCE_B + bank);
 }
 
+/**
+ * 0 : An event on this IO will trigger an interrupt
+ * 1 : An event on this IO will NOT trigger an interrupt
+*/
+void SX1509::setInteruptMask16(uint16_t mask)
+{
+  this->regWrite16(REG_INTERRUPT_MASK_B, mask);
+}
+
+/**
+ * Interrupt source of all 16 IOs, read from RegInterruptSourceB and RegInterruptSourceA in a single transaction
+*/
+uint16_t SX1509::getInteruptSource16()
+{
+  return this->i2cRead16(REG_INTERRUPT_SOURCE_B);
+}
+
+/**
+ * Writing '1' clears the bit in RegInterruptSource and in RegEventStatus (not shadowed, always written)
+*/
+void SX1509::clearInteruptSource16(uint16_t sources)
+{
+  this->i2cWrite(REG_INTERRUPT_SOURCE_B, sources >> 8, sources & 0xFF);
+}
+
+/**
+ * RegMisc bit 1 --> 0: RegInterruptSource is auto-cleared when RegData is read (default)
+ *                   1: sources are only cleared by writing RegInterruptSource (clearInteruptSource16)
+*/
+void SX1509::setInteruptAutoClear(bool enable)
+{
+  this->regWriteBit(REG_MISC, 1, !enable);
+}
+
+/** Interrupt Event Engine
+ * 
+ * The driver takes ownership of an InterruptIn on the NINT pin. The NINT ISR only records a timestamp and defers
+ * to serviceInterupt() on the given EventQueue, so idle buses carry no traffic at all.
+ * 
+ * Use enableInterupt() / configurePins() to choose which IOs generate interrupts, then consume the
+ * captured edges with readEvent().
+*/
+void SX1509::enableInteruptEvents(PinName nintPin, EventQueue *queue /*mbed_event_queue()*/)
+{
+  if (nint == NULL) {
+    nint = new InterruptIn(nintPin, PullUp); // NINT is open drain
+  }
+  eventQueue = queue;
+  nint->fall(callback(this, &SX1509::nintFallCallback));
+
+  // the event engine reads RegData before the sources, so they must not be auto-cleared by that read
+  // (this also keeps application reads of the IOs from discarding pending events)
+  this->setInteruptAutoClear(false);
+
+  // clear anything left over so NINT is released and the next edge is seen
+  this->clearInteruptSource16(0xFFFF);
+}
+
+void SX1509::disableInteruptEvents()
+{
+  if (nint != NULL) {
+    delete nint;
+    nint = NULL;
+  }
+  this->setInteruptAutoClear(true); // back to the default, for polling with getInteruptSource() + digitalRead()
+}
+
+/**
+ * to attach a function     -->   attachEventCallback(&myFunc)
+ * to attach a class method -->   attachEventCallback(callback(this, &MyClass::myClassMethod))
+*/
+void SX1509::attachEventCallback(Callback<void()> func)
+{
+  eventCallback = func;
+}
+
+void SX1509::nintFallCallback()
+{
+  nintTimestamp = us_ticker_read();
+  eventQueue->call(callback(this, &SX1509::handleInterupt));
+}
+
+/**
+ * NINT still asserted after servicing means no new falling edge will occur, so service it again. A source the driver
+ * can't clear would otherwise re-post forever, so retries stop after SX1509_NINT_MAX_RETRIES passes that queued nothing.
+*/
+void SX1509::handleInterupt()
+{
+  int count = this->serviceInterupt();
+  if (nint == NULL || nint->read() != 0) {
+    nintRetries = 0;
+    return;
+  }
+  nintRetries = count ? 0 : nintRetries + 1;
+  if (nintRetries < SX1509_NINT_MAX_RETRIES) {
+    eventQueue->call(callback(this, &SX1509::handleInterupt));
+  } else {
+    nintRetries = 0;
+  }
+}
+
+/**
+ * RegDataB -> RegInterruptSourceA are read in one 10 byte burst, the triggered sources are cleared and
+ * an event is queued for each of them, using the IO state to determine the edge direction.
+ * 
+ * When the keypad engine is enabled RegKeyData1/2 are read first (a single two byte read), and the IO burst
+ * is skipped entirely if no IO interrupt is unmasked.
+ * 
+ * returns the number of events queued
+*/
+int SX1509::serviceInterupt()
+{
+  return this->serviceInterupt(nintTimestamp);
+}
+
+/**
+ * timestamp : the time NINT was asserted, for when NINT is shared and handled elsewhere (ie. SX1509Array)
+*/
+int SX1509::serviceInterupt(uint32_t timestamp)
+{
+  int count = 0;
+
+  if (this->keypadEnabled()) {
+    uint16_t keyData = this->readKeyData();
+    if ((keyData & 0xFF00) && (keyData & 0x00FF)) {
+      count += this->pushEvent(getKeyIndex(keyData), KEY_PRESS, timestamp);
+    }
+  }
+
+  if (regRead16(REG_INTERRUPT_MASK_B) != 0xFFFF) {
+    uint8_t regs[REG_INTERRUPT_SOURCE_A - REG_DATA_B + 1];
+    this->i2cReadBurst(REG_DATA_B, regs, sizeof(regs));
+
+    uint16_t data = (regs[REG_DATA_B - REG_DATA_B] << 8) | regs[REG_DATA_A - REG_DATA_B];
+    uint16_t sources = (regs[REG_INTERRUPT_SOURCE_B - REG_DATA_B] << 8) | regs[REG_INTERRUPT_SOURCE_A - REG_DATA_B];
+    if (sources) {
+      this->clearInteruptSource16(sources);
+    }
+
+    for (int pin = 0; pin < 16; pin++)
+    {
+      if (bitRead(sources, pin)) {
+        count += this->pushEvent(pin, bitRead(data, pin) ? PIN_RISE : PIN_FALL, timestamp);
+      }
+    }
+  }
+
+  if (count && eventCallback) {
+    eventCallback();
+  }
+  return count;
+}
+
+bool SX1509::pushEvent(uint8_t pin, EventType type, uint32_t timestamp)
+{
+  uint8_t head = eventHead;
+  uint8_t next = (head + 1) & (SX1509_EVENT_QUEUE_SIZE - 1);
+  if (next == eventTail) {
+    return false; // queue full, event dropped
+  }
+  eventBuffer[head].pin = pin;
+  eventBuffer[head].type = type;
+  eventBuffer[head].timestamp = timestamp;
+  __DMB(); // event must be written before it is published
+  eventHead = next;
+  return true;
+}
+
+/**
+ * pops the oldest queued event into *event, returns false when the queue is empty
+*/
+bool SX1509::readEvent(Event *event)
+{
+  uint8_t tail = eventTail;
+  if (tail == eventHead) {
+    return false;
+  }
+  __DMB();
+  *event = eventBuffer[tail];
+  eventTail = (tail + 1) & (SX1509_EVENT_QUEUE_SIZE - 1);
+  return true;
+}
+
+int SX1509::eventsPending()
+{
+  return (eventHead - eventTail) & (SX1509_EVENT_QUEUE_SIZE - 1);
+}
+
+/** Keypad Engine
+ * 
+ * Offloads scanning of a button matrix (up to 8 x 8) to the SX1509. Rows are driven on IO[0:rows-1] (open drain
+ * outputs) and columns are sensed on IO[8:8+columns-1] (debounced inputs with pull-ups). Key presses assert NINT,
+ * and are delivered as KEY_PRESS events when the interrupt event engine is enabled, or via readKeyData().
+ * 
+ * rows    : 2 - 8  (1 row is not supported by the keypad engine)
+ * columns : 1 - 8
+ * Out of range values are ignored and no register is touched.
+ * 
+ * scanTime (scan time per row, must be larger than the debounce time):
+ *  0: 1ms, 1: 2ms, 2: 4ms, 3: 8ms, 4: 16ms, 5: 32ms, 6: 64ms, 7: 128ms  (x 2MHz/fOSC)
+ * 
+ * sleepTime (auto sleep time, no key press within this time sets the keypad engine to sleep):
+ *  0: OFF, 1: 128ms, 2: 256ms, 3: 512ms, 4: 1s, 5: 2s, 6: 4s, 7: 8s  (x 2MHz/fOSC)
+ * 
+ * Note: the common debounce time (RegDebounceConfig) is set to half the row scan time.
+*/
+void SX1509::keypad(int rows, int columns, uint8_t scanTime /*0*/, uint8_t sleepTime /*0*/)
+{
+  if (rows < 2 || rows > 8 || columns < 1 || columns > 8) {
+    return; // out of range values would wrap into RegKeyConfig2 and reconfigure the wrong IO
+  }
+
+  uint16_t rowPins = (1 << rows) - 1;             // IO[0:7]
+  uint16_t columnPins = ((1 << columns) - 1) << 8; // IO[8:15]
+
+  this->setDirection16((regRead16(REG_DIR_B) & ~rowPins) | columnPins);
+  this->regWrite16(REG_OPEN_DRAIN_B, regRead16(REG_OPEN_DRAIN_B) | rowPins);
+  this->setPullup16(regRead16(REG_PULL_UP_B) | columnPins);
+
+  this->setDebounceTime(scanTime & 0x07);
+  this->regWrite16(REG_DEBOUNCE_ENABLE_B, regRead16(REG_DEBOUNCE_ENABLE_B) | columnPins);
+
+  // RegKeyConfig1: | - | sleep time 6:4 | - | scan time 2:0 |
+  // RegKeyConfig2: | - | - | rows - 1 (5:3) | columns - 1 (2:0) |
+  uint8_t keyConfig[2];
+  keyConfig[0] = ((sleepTime & 0x07) << 4) | (scanTime & 0x07);
+  keyConfig[1] = (((rows - 1) & 0x07) << 3) | ((columns - 1) & 0x07);
+  this->regWriteBurst(REG_KEY_CONFIG_1, keyConfig, 2);
+}
+
+/**
+ * RegKeyData1 (column) and RegKeyData2 (row) in a single two byte read. Reading clears NINT.
+ * 
+ * The registers are active low, this returns them inverted so a pressed key has one bit set in each byte:
+ *  bits 15:8 --> row
+ *  bits 7:0  --> column
+ * 0 means no key is pressed.
+*/
+uint16_t SX1509::readKeyData()
+{
+  uint8_t keyData[2];
+  this->i2cReadBurst(REG_KEY_DATA_1, keyData, 2);
+  return (uint16_t)(~((keyData[1] << 8) | keyData[0]));
+}
+
+/**
+ * converts the value returned by readKeyData() into a key index: (row * 8) + column
+*/
+int SX1509::getKeyIndex(uint16_t keyData)
+{
+  return (getKeyRow(keyData) * 8) + getKeyColumn(keyData);
+}
+
+int SX1509::getKeyRow(uint16_t keyData)
+{
+  for (int row = 0; row < 8; row++)
+  {
+    if (bitRead(keyData, row + 8)) { return row; }
+  }
+  return -1;
+}
+
+int SX1509::getKeyColumn(uint16_t keyData)
+{
+  for (int column = 0; column < 8; column++)
+  {
+    if (bitRead(keyData, column)) { return column; }
+  }
+  return -1;
+}
+
 /** 
  * Each input can be individually debounced by setting corresponding bits in RegDebounce register.
  * At power up the debounce function is disabled. After enabling the debouncer, the change of the input value 
@@ -142,9 +508,7 @@ void SX1509::setInputDebounce(int pin, bool debounce)
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_DEBOUNCE_ENABLE_B + bank;
-  int hotValue = this->i2cRead(reg);
-  this->i2cWrite(reg, bitWrite(hotValue, pinPos, debounce));
-  hotValue = this->i2cRead(reg);
+  this->regWriteBit(reg, pinPos, debounce);
 }
 
 /**
@@ -160,7 +524,7 @@ void SX1509::setInputDebounce(int pin, bool debounce)
   7: 64ms x 2MHz/fOSC
 */
 void SX1509::setDebounceTime(int value) {
-  this->i2cWrite(REG_DEBOUNCE_CONFIG, value);
+  this->regWrite(REG_DEBOUNCE_CONFIG, value);
 }
 
 /** Software Reset
@@ -169,6 +533,51 @@ void SX1509::setDebounceTime(int value) {
 void SX1509::reset() {
   this->i2cWrite(REG_RESET, 0x12);
   this->i2cWrite(REG_RESET, 0x34);
+  this->resetCache();
+}
+
+/** Register Shadow Cache
+ * Every writable configuration / data register is mirrored in regCache so that per-pin
+ * methods can modify bits locally and only touch the bus when a register value actually changes.
+ * 
+ * Rather than reading the registers back, the cache is seeded with the datasheet power-on / reset defaults:
+ *  RegDir, RegData and RegInterruptMask --> 1111 1111
+ *  everything else                      --> 0000 0000
+*/
+void SX1509::resetCache() {
+  memset(regCache, 0x00, sizeof(regCache));
+  regCache[REG_DIR_B] = 0xFF;
+  regCache[REG_DIR_A] = 0xFF;
+  regCache[REG_DATA_B] = 0xFF;
+  regCache[REG_DATA_A] = 0xFF;
+  regCache[REG_INTERRUPT_MASK_B] = 0xFF;
+  regCache[REG_INTERRUPT_MASK_A] = 0xFF;
+
+  // LED driver registers: RegIOn --> 1111 1111, everything else --> 0000 0000
+  memset(ledFrame, 0x00, sizeof(ledFrame));
+  for (int pin = 0; pin < 16; pin++)
+  {
+    ledFrame[regIOn(pin) - REG_T_ON_0] = 0xFF;
+  }
+  ledDirty = 0;
+}
+
+/**
+ * Write a block of consecutive shadowed registers, trimming the unchanged registers at either end
+ * so that only the span which actually differs from the cache goes out, in a single transaction.
+*/
+void SX1509::regWriteBurst(int reg, const uint8_t *values, int count)
+{
+  int first = 0;
+  int last = count - 1;
+  while (first <= last && regCache[reg + first] == values[first]) { first++; }
+  while (last >= first && regCache[reg + last] == values[last]) { last--; }
+  if (first > last) {
+    return; // nothing changed
+  }
+
+  memcpy(&regCache[reg + first], &values[first], last - first + 1);
+  this->i2cWriteBurst(reg + first, &values[first], last - first + 1);
 }
 
 /** LED Driver Configuration
@@ -191,28 +600,39 @@ Below are the steps required to use the LED driver with the typical LED connecti
 
 void SX1509::ledConfig(int pin)
 {
-  int hotConfig; // the current value of the register
-  int reg;       // register to read/write
-  int bank = getBank(pin);
-  int pinNum = getPinPos(pin);
+  this->ledConfigMask(1 << pin);
+}
 
-  reg = REG_INPUT_DISABLE_B + bank;
-  hotConfig = this->i2cRead(reg);
-  this->i2cWrite(reg, bitWrite(hotConfig, pinNum, 1)); // Disable the input buffer (HIGH)
+/**
+ * Configure any subset of the 16 IOs as LED driver outputs in one pass (bit position == pin number)
+ * 
+ * RegInputDisable, RegPullUp, RegOpenDrain and RegDir are written as a single auto-increment burst, whose
+ * ascending address order matches the datasheet setup order, followed by RegLEDDriverEnable and RegData.
+ * The clock (RegClock / RegMisc) is configured in init().
+*/
+void SX1509::ledConfigMask(uint16_t pins)
+{
+  uint8_t image[REG_DIR_A - REG_INPUT_DISABLE_B + 1];
+  memcpy(image, &regCache[REG_INPUT_DISABLE_B], sizeof(image));
 
-  this->disablePullup(pin); // remove internal pull-up (LOW)
-  
-  reg = REG_OPEN_DRAIN_B + bank;
-  hotConfig = this->i2cRead(reg);
-  this->i2cWrite(reg, bitWrite(hotConfig, pinNum, 1)); // set IO to open drain (HIGH)
+  uint16_t inputDisable = regRead16(REG_INPUT_DISABLE_B) | pins; // Disable the input buffer (HIGH)
+  uint16_t pullup = regRead16(REG_PULL_UP_B) & ~pins;            // remove internal pull-up (LOW)
+  uint16_t openDrain = regRead16(REG_OPEN_DRAIN_B) | pins;       // set IO to open drain (HIGH)
+  uint16_t dir = regRead16(REG_DIR_B) & ~pins;                   // Set IO direction to output (LOW)
 
-  this->setDirection(pin, 0); // Set IO direction to output (LOW)
+  image[REG_INPUT_DISABLE_B] = inputDisable >> 8;
+  image[REG_INPUT_DISABLE_A] = inputDisable & 0xFF;
+  image[REG_PULL_UP_B] = pullup >> 8;
+  image[REG_PULL_UP_A] = pullup & 0xFF;
+  image[REG_OPEN_DRAIN_B] = openDrain >> 8;
+  image[REG_OPEN_DRAIN_A] = openDrain & 0xFF;
+  image[REG_DIR_B] = dir >> 8;
+  image[REG_DIR_A] = dir & 0xFF;
+  this->regWriteBurst(REG_INPUT_DISABLE_B, image, sizeof(image));
 
-  reg = REG_LED_DRIVER_ENABLE_B + bank;
-  hotConfig = this->i2cRead(reg);
-  this->i2cWrite(reg, bitWrite(hotConfig, pinNum, 1));
+  this->regWrite16(REG_LED_DRIVER_ENABLE_B, regRead16(REG_LED_DRIVER_ENABLE_B) | pins);
 
-  this->digitalWrite(pin, 0); // setting data LOW means LED Driver started
+  this->regWrite16(REG_DATA_B, regRead16(REG_DATA_B) & ~pins); // setting data LOW means LED Driver started
 }
 
 /**
@@ -228,7 +648,7 @@ void SX1509::digitalWrite(int pin, int value) {
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_DATA_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, value));
+  this->regWriteBit(reg, pinPos, value);
 }
 
 int SX1509::digitalRead(int pin)
@@ -259,7 +679,7 @@ uint8_t SX1509::readBankB()
 */ 
 void SX1509::writeBankA(uint8_t data)
 {
-  this->i2cWrite(REG_DATA_A, data);
+  this->regWrite(REG_DATA_A, data);
 }
 
 /**
@@ -267,11 +687,29 @@ void SX1509::writeBankA(uint8_t data)
 */
 void SX1509::writeBankB(uint8_t data)
 {
-  this->i2cWrite(REG_DATA_B, data);
+  this->regWrite(REG_DATA_B, data);
 }
 
 
 
+/**
+ * returns the state of all 16 IOs, read from RegDataB and RegDataA in a single transaction
+ * bits 15:8 --> Bank B (IO[15:8])
+ * bits 7:0  --> Bank A (IO[7:0])
+*/
+uint16_t SX1509::read16()
+{
+  return this->i2cRead16(REG_DATA_B);
+}
+
+/**
+ * write a 16-bit value to all 16 pins (RegDataB + RegDataA) in a single transaction
+*/
+void SX1509::write16(uint16_t data)
+{
+  this->regWrite16(REG_DATA_B, data);
+}
+
 /**
  * 0 : IO is configured as an output
  * 1 : IO is configured as an input
@@ -281,7 +719,12 @@ void SX1509::setDirection(int pin, int inOut)
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_DIR_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, inOut));
+  this->regWriteBit(reg, pinPos, inOut);
+}
+
+void SX1509::setDirection16(uint16_t inOut)
+{
+  this->regWrite16(REG_DIR_B, inOut);
 }
 
 void SX1509::enablePullup(int pin)
@@ -289,7 +732,7 @@ void SX1509::enablePullup(int pin)
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_PULL_UP_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, 1));
+  this->regWriteBit(reg, pinPos, 1);
 }
 
 void SX1509::disablePullup(int pin)
@@ -297,7 +740,16 @@ void SX1509::disablePullup(int pin)
   int bank = getBank(pin);
   int pinPos = getPinPos(pin);
   int reg = REG_PULL_UP_B + bank;
-  this->i2cWrite(reg, bitWrite(this->i2cRead(reg), pinPos, 0));
+  this->regWriteBit(reg, pinPos, 0);
+}
+
+/**
+ * 0 : Pull-up disabled
+ * 1 : Pull-up enabled
+*/
+void SX1509::setPullup16(uint16_t pullups)
+{
+  this->regWrite16(REG_PULL_UP_B, pullups);
 }
 
 /** LED PWM
@@ -308,7 +760,15 @@ void SX1509::disablePullup(int pin)
 */
 void SX1509::setPWM(int pin, int value)
 {
-  this->i2cWrite(REG_I_ON[pin], value); // sets the PWM / brightness
+  this->ledWrite(regIOn(pin), value); // sets the PWM / brightness
+}
+
+/**
+ * perceptual brightness (0 - 255), gamma corrected through a compile-time table before being written as PWM
+*/
+void SX1509::setBrightness(int pin, uint8_t brightness)
+{
+  this->setPWM(pin, gammaCorrect<SX1509_GAMMA>(brightness));
 }
 
 /** LED Driver Blink Mode
@@ -319,10 +779,10 @@ void SX1509::setPWM(int pin, int value)
 */
 void SX1509::blinkLED(int pin, uint8_t onTime, uint8_t offTime, uint8_t onIntensity, uint8_t offIntensity)
 {
-  this->i2cWrite(REG_T_ON[pin], (onTime > 31) ? 31 : onTime);
-  this->setPWM(pin, onIntensity);
-  
-  this->setOffTime(pin, offTime, offIntensity);
+  this->bufferOnTime(pin, onTime);
+  this->bufferPWM(pin, onIntensity);
+  this->bufferOffTime(pin, offTime, offIntensity);
+  this->ledFlushRange(regTOn(pin), 3); // RegTOn, RegIOn and RegOff are adjacent
 }
 
 /**
@@ -334,7 +794,7 @@ onTime:
   16 - 31 : TOnX = 512 * RegTOnX * (255/ClkX)
 */
 void SX1509::setOnTime(int pin, uint8_t onTime) {
-  this->i2cWrite(REG_T_ON[pin], (onTime > 31) ? 31 : onTime);
+  this->ledWrite(regTOn(pin), (onTime > 31) ? 31 : onTime);
 }
 
 /**
@@ -354,33 +814,308 @@ void SX1509::setOffTime(int pin, uint8_t offTime, uint8_t offIntensity)
 {
   uint8_t offValue = offTime << 3;   // offTime is 5 bits, from bit 7:3
   offValue |= (offIntensity & 0x07); // offIntensity is a 3 bit number, from bit 2:0
-  this->i2cWrite(REG_OFF[pin], offValue);
+  this->ledWrite(regOff(pin), offValue);
+}
+
+/** LED Framebuffer
+ * 
+ * The LED driver registers (RegTOn0 -> RegTFall15) are shadowed in ledFrame. The buffer*() methods only update
+ * the frame and mark the register dirty; flush() then writes just the dirty registers, grouping them into
+ * auto-increment bursts. Clean gaps of up to LED_FLUSH_MAX_GAP registers are re-sent as part of a burst, as
+ * that is cheaper than starting a new transaction.
+*/
+void SX1509::bufferPWM(int pin, int value)
+{
+  if (pin < 0 || pin > 15) {
+    return;
+  }
+  this->ledBuffer(regIOn(pin), value);
+}
+
+void SX1509::bufferBrightness(int pin, uint8_t brightness)
+{
+  if (pin < 0 || pin > 15) {
+    return;
+  }
+  this->ledBuffer(regIOn(pin), gammaCorrect<SX1509_GAMMA>(brightness));
+}
+
+void SX1509::bufferOnTime(int pin, uint8_t onTime)
+{
+  if (pin < 0 || pin > 15) {
+    return;
+  }
+  this->ledBuffer(regTOn(pin), (onTime > 31) ? 31 : onTime);
+}
+
+void SX1509::bufferOffTime(int pin, uint8_t offTime, uint8_t offIntensity)
+{
+  if (pin < 0 || pin > 15) {
+    return;
+  }
+  this->ledBuffer(regOff(pin), (offTime << 3) | (offIntensity & 0x07));
+}
+
+void SX1509::flush()
+{
+  int offset = 0;
+  while (ledDirty >> offset)
+  {
+    while (!((ledDirty >> offset) & 1)) { offset++; } // skip to the next dirty register
+
+    int end = offset; // last dirty register of this run
+    for (int i = offset + 1; i < LED_FRAME_SIZE && i - end <= LED_FLUSH_MAX_GAP + 1; i++)
+    {
+      if ((ledDirty >> i) & 1) { end = i; }
+    }
+
+    this->ledFlushRange(REG_T_ON_0 + offset, end - offset + 1);
+    offset = end + 1;
+    if (offset >= LED_FRAME_SIZE) { break; }
+  }
+}
+
+/**
+ * write count consecutive LED driver registers from the frame in one burst, and mark them clean
+*/
+void SX1509::ledFlushRange(int reg, int count)
+{
+  int offset = reg - REG_T_ON_0;
+  this->i2cWriteBurst(reg, &ledFrame[offset], count);
+  for (int i = offset; i < offset + count; i++)
+  {
+    ledDirty &= ~(1ULL << i);
+  }
+}
+
+/**
+ * update a register in the frame without writing it
+*/
+void SX1509::ledBuffer(int reg, uint8_t value)
+{
+  int offset = reg - REG_T_ON_0;
+  if (offset < 0 || offset >= LED_FRAME_SIZE) {
+    return;
+  }
+  if (ledFrame[offset] != value) {
+    ledFrame[offset] = value;
+    ledDirty |= (1ULL << offset);
+  }
+}
+
+/**
+ * write a register immediately, skipping the transaction when it already holds the value
+*/
+void SX1509::ledWrite(int reg, uint8_t value)
+{
+  int offset = reg - REG_T_ON_0;
+  if (offset < 0 || offset >= LED_FRAME_SIZE) {
+    return;
+  }
+  if (ledFrame[offset] != value || ((ledDirty >> offset) & 1)) {
+    ledFrame[offset] = value;
+    this->i2cWrite(reg, value);
+    ledDirty &= ~(1ULL << offset);
+  }
 }
 
 void SX1509::setBlinkFrequency(ClockSpeed speed)
 {
-  int data = this->i2cRead(REG_MISC);
+  int data = this->regRead(REG_MISC);
   int mask = 0b10001111; // targeting bits 6:4
   data &= mask;
   data |= speed;
-  this->i2cWrite(REG_MISC, data);
+  this->regWrite(REG_MISC, data);
 }
 
 /**
- * implementation not fully complete. 
+ * LED driver mode, applies to both banks
+ * RegMisc bit 7 --> Bank B (IO[15:8])
+ * RegMisc bit 3 --> Bank A (IO[7:0])
+ * 
+ * 0 : Linear
+ * 1 : Logarithmic (fading capable IOs only, gives perceptually smooth fades)
  */
 void SX1509::setDriverMode(bool linear)
 {
-  int hotValue = this->i2cRead(REG_MISC);
+  int hotValue = this->regRead(REG_MISC);
   if (linear) {
     hotValue = bitClear(hotValue, 7);
+    hotValue = bitClear(hotValue, 3);
   }
   else {
     hotValue = bitSet(hotValue, 7);
+    hotValue = bitSet(hotValue, 3);
   }
-  this->i2cWrite(REG_MISC, hotValue);
+  this->regWrite(REG_MISC, hotValue);
 };
 
+/** LED Effects
+ * 
+ * Effects program the on-chip LED engine (RegTOn, RegIOn, RegOff, RegTRise, RegTFall) in a single burst per pin
+ * and then run entirely in silicon, with no ongoing bus traffic. RegTRise / RegTFall only exist on the fading
+ * capable IOs (IO[4:7] and IO[12:15]), other IOs step directly between the on and off intensities.
+ * 
+ * Times are given in milliseconds and converted to the nearest register value for the ClkX currently
+ * configured in RegMisc (see setBlinkFrequency()). offIntensity is the 3 bit RegOff[2:0] value (IOff = 4 x offIntensity).
+ * 
+ * Use setDriverMode(false) for logarithmic (perceptually smooth) fades.
+*/
+
+/**
+ * continuous blink with fade in / fade out
+*/
+void SX1509::breathe(int pin, int onMs, int offMs, int riseMs, int fallMs, uint8_t onIntensity /*255*/, uint8_t offIntensity /*0*/)
+{
+  this->ledEffect(pin, msToOnTime(onMs), onIntensity, msToOnTime(offMs), offIntensity,
+    msToFadeTime(riseMs, onIntensity, offIntensity), msToFadeTime(fallMs, onIntensity, offIntensity));
+  this->digitalWrite(pin, 0); // LED driver started
+}
+
+/**
+ * continuous blink without fading
+*/
+void SX1509::pulse(int pin, int onMs, int offMs, uint8_t onIntensity /*255*/, uint8_t offIntensity /*0*/)
+{
+  this->ledEffect(pin, msToOnTime(onMs), onIntensity, msToOnTime(offMs), offIntensity, 0, 0);
+  this->digitalWrite(pin, 0);
+}
+
+/**
+ * Static mode (RegTOn == 0), RegData directly controls the LED and the engine fades between the off and on intensities:
+ *  intensity > 0 --> RegIOn = intensity and fade in over ms
+ *  intensity == 0 --> fade out over ms
+*/
+void SX1509::fadeTo(int pin, uint8_t intensity, int ms)
+{
+  uint8_t offIntensity = ledFrame[regOff(pin) - REG_T_ON_0] & 0x07;
+  uint8_t onIntensity = (intensity > 0) ? intensity : ledFrame[regIOn(pin) - REG_T_ON_0];
+  uint8_t riseTime = 0;
+  uint8_t fallTime = 0;
+  if (canFade(pin)) {
+    riseTime = ledFrame[regTRise(pin) - REG_T_ON_0];
+    fallTime = ledFrame[regTFall(pin) - REG_T_ON_0];
+  }
+
+  if (intensity > 0) {
+    this->ledEffect(pin, 0, onIntensity, 0, offIntensity, msToFadeTime(ms, onIntensity, offIntensity), fallTime);
+    this->digitalWrite(pin, 0);
+  } else {
+    this->ledEffect(pin, 0, onIntensity, 0, offIntensity, riseTime, msToFadeTime(ms, onIntensity, offIntensity));
+    this->digitalWrite(pin, 1);
+  }
+}
+
+/**
+ * One-shot mode (RegOff[7:3] == 0): the LED turns on for onMs and then stays off until the next flash()
+*/
+void SX1509::flash(int pin, int onMs, int riseMs /*0*/, int fallMs /*0*/, uint8_t onIntensity /*255*/)
+{
+  this->ledEffect(pin, msToOnTime(onMs), onIntensity, 0, 0, msToFadeTime(riseMs, onIntensity, 0), msToFadeTime(fallMs, onIntensity, 0));
+  this->digitalWrite(pin, 1); // RegData must toggle high -> low to (re)trigger the shot
+  this->digitalWrite(pin, 0);
+}
+
+/**
+ * set the raw fade in / fade out register values of a fading capable IO
+*/
+void SX1509::setFadeTime(int pin, uint8_t riseTime, uint8_t fallTime)
+{
+  if (!canFade(pin)) {
+    return;
+  }
+  this->ledBuffer(regTRise(pin), (riseTime > 31) ? 31 : riseTime);
+  this->ledBuffer(regTFall(pin), (fallTime > 31) ? 31 : fallTime);
+  this->ledFlushRange(regTRise(pin), 2);
+}
+
+/**
+ * ClkX period * 255, in half microseconds (fOSC assumed to be 2MHz, ie. the internal oscillator)
+ * ClkX = fOSC/(2^(RegMisc[6:4]-1))
+*/
+uint32_t SX1509::ledTick()
+{
+  int divider = (regRead(REG_MISC) >> 4) & 0x07;
+  if (divider == 0) {
+    return 0; // LED driver clock is OFF
+  }
+  return 255UL << (divider - 1);
+}
+
+/**
+ * returns whichever of the two register ranges (1 - 15 and 16 - 31) gives the time closest to target
+ *  1 - 15  : time = value * lowStep
+ *  16 - 31 : time = value * highStep
+*/
+uint8_t SX1509::nearestTime(uint32_t target, uint32_t lowStep, uint32_t highStep)
+{
+  if (target == 0 || lowStep == 0) {
+    return 0;
+  }
+  uint32_t low = (target + lowStep / 2) / lowStep;
+  low = (low < 1) ? 1 : (low > 15) ? 15 : low;
+  uint32_t high = (target + highStep / 2) / highStep;
+  high = (high < 16) ? 16 : (high > 31) ? 31 : high;
+
+  uint32_t lowError = (low * lowStep > target) ? low * lowStep - target : target - low * lowStep;
+  uint32_t highError = (high * highStep > target) ? high * highStep - target : target - high * highStep;
+  return (lowError <= highError) ? low : high;
+}
+
+/**
+ * RegTOn / RegOff[7:3] value closest to ms
+ *  1 - 15  : T = 64 * value * (255/ClkX)
+ *  16 - 31 : T = 512 * value * (255/ClkX)
+ * 0 ms (or less) returns 0 (static / single shot mode)
+*/
+uint8_t SX1509::msToOnTime(int ms)
+{
+  if (ms < 0) {
+    ms = 0;
+  }
+  uint32_t tick = ledTick();
+  return nearestTime(ms * 2000UL, 64 * tick, 512 * tick);
+}
+
+uint8_t SX1509::msToOffTime(int ms)
+{
+  return msToOnTime(ms);
+}
+
+/**
+ * RegTRise / RegTFall value closest to ms, the fade time depends on the intensity range being faded over
+ *  1 - 15  : T = (RegIOn - 4 * RegOff[2:0]) * value * (255/ClkX)
+ *  16 - 31 : T = 16 * (RegIOn - 4 * RegOff[2:0]) * value * (255/ClkX)
+*/
+uint8_t SX1509::msToFadeTime(int ms, uint8_t onIntensity, uint8_t offIntensity)
+{
+  if (ms < 0) {
+    ms = 0;
+  }
+  int range = onIntensity - (4 * (offIntensity & 0x07));
+  if (range <= 0) {
+    return 0;
+  }
+  uint32_t step = range * ledTick();
+  return nearestTime(ms * 2000UL, step, 16 * step);
+}
+
+/**
+ * buffer a pin's complete LED engine configuration and write it as one burst
+ * (RegTOn, RegIOn, RegOff and, on fading capable IOs, RegTRise, RegTFall are adjacent)
+*/
+void SX1509::ledEffect(int pin, uint8_t onTime, uint8_t onIntensity, uint8_t offTime, uint8_t offIntensity, uint8_t riseTime, uint8_t fallTime)
+{
+  this->bufferOnTime(pin, onTime);
+  this->bufferPWM(pin, onIntensity);
+  this->bufferOffTime(pin, (offTime > 31) ? 31 : offTime, offIntensity);
+  if (canFade(pin)) {
+    this->ledBuffer(regTRise(pin), (riseTime > 31) ? 31 : riseTime);
+    this->ledBuffer(regTFall(pin), (fallTime > 31) ? 31 : fallTime);
+  }
+  this->ledFlushRange(regTOn(pin), canFade(pin) ? 5 : 3);
+}
+
 // configure Clock
 
 /**
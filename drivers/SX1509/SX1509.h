@@ -4,12 +4,20 @@
 
 #include <mbed.h>
 #include "BitwiseMethods.h"
+#include "GammaTable.h"
 
 #define SX1509_ADDR  0x3E
 // 01 | 0x3F | (0111111)
 // 10 | 0x70 | (1110000)
 // 11 | 0x71 | (1110001)
 
+#define SX1509_EVENT_QUEUE_SIZE  16  // must be a power of 2
+#define SX1509_NINT_MAX_RETRIES  8   // consecutive re-services of a stuck NINT before giving up until the next edge
+
+#ifndef SX1509_GAMMA
+#define SX1509_GAMMA  GAMMA_DEFAULT  // exponent * 100 used by setBrightness()
+#endif
+
 class SX1509 {
 public:
   enum PinMode
@@ -43,16 +51,56 @@ public:
     RISE_FALL = 3,
   };
 
+  /** A single entry of the 16 pin configuration table passed to configurePins()
+   * mode           : INPUT, OUTPUT or ANALOG_OUTPUT (LED driver)
+   * pullup         : enable the internal pull-up (ignored for ANALOG_OUTPUT)
+   * debounce       : enable the input debouncer
+   * invertPolarity : invert the IO polarity
+   * interupt       : edge sense of the IO interrupt, NONE leaves the IO masked
+  */
+  struct PinConfig
+  {
+    PinMode mode;
+    bool pullup;
+    bool debounce;
+    bool invertPolarity;
+    InteruptDirection interupt;
+  };
+
+  enum EventType
+  {
+    PIN_FALL = 0,
+    PIN_RISE = 1,
+    KEY_PRESS = 2,
+  };
+
+  /** An input edge / key press captured by the interrupt event engine
+   * pin       : IO number, or the key index (row * 8 + column) for KEY_PRESS events
+   * timestamp : us_ticker_read() at the falling edge of NINT
+  */
+  struct Event
+  {
+    uint8_t pin;
+    EventType type;
+    uint32_t timestamp;
+  };
+
   SX1509(I2C *_i2c, char _addr = SX1509_ADDR) {
 		address = _addr << 1;
 		i2c = _i2c;
+		nint = NULL;
+		eventQueue = NULL;
+		eventHead = 0;
+		eventTail = 0;
+		nintRetries = 0;
+		resetCache();
 	};
 
 	I2C * i2c;
 	char address;
-  char REG_I_ON[16] = { REG_I_ON_0, REG_I_ON_1, REG_I_ON_2, REG_I_ON_3, REG_I_ON_4, REG_I_ON_5, REG_I_ON_6, REG_I_ON_7, REG_I_ON_8, REG_I_ON_9, REG_I_ON_10, REG_I_ON_11, REG_I_ON_12, REG_I_ON_13, REG_I_ON_14, REG_I_ON_15 };
-  char REG_T_ON[16] = { REG_T_ON_0, REG_T_ON_1, REG_T_ON_2, REG_T_ON_3, REG_T_ON_4, REG_T_ON_5, REG_T_ON_6, REG_T_ON_7, REG_T_ON_8, REG_T_ON_9, REG_T_ON_10, REG_T_ON_11, REG_T_ON_12, REG_T_ON_13, REG_T_ON_14, REG_T_ON_15 };
-  char REG_OFF[16] = { REG_OFF_0, REG_OFF_1, REG_OFF_2, REG_OFF_3, REG_OFF_4, REG_OFF_5, REG_OFF_6, REG_OFF_7, REG_OFF_8, REG_OFF_9, REG_OFF_10, REG_OFF_11, REG_OFF_12, REG_OFF_13, REG_OFF_14, REG_OFF_15};
+	InterruptIn *nint;               // only allocated when the interrupt event engine is enabled
+	EventQueue *eventQueue;          // NINT handling is deferred onto this queue (out of ISR context)
+	Callback<void()> eventCallback;  // optional, called (from eventQueue) after new events have been queued
   /** Software Reset
 	 */
   void init(bool extClock=false);
@@ -64,16 +112,38 @@ public:
   uint8_t readBankB();
   void writeBankA(uint8_t data);
   void writeBankB(uint8_t data);
+  uint16_t read16();
+  void write16(uint16_t data);
 
   void ledConfig(int pin);
+  void ledConfigMask(uint16_t pins);
   void setDirection(int pin, int inOut);
   void setPolarity(int pin, int polarity);
   void pinMode(int pin, PinMode mode, bool invertPolarity = false); // should handle all types of pin modes
+  void configurePins(const PinConfig config[16]);
   void setPWM(int pin, int value);
+  void setBrightness(int pin, uint8_t brightness);
   void blinkLED(int pin, uint8_t onTime, uint8_t offTime, uint8_t onIntensity, uint8_t offIntensity);
   void setBlinkFrequency(ClockSpeed speed);
   void setOnTime(int pin, uint8_t onTime);
   void setOffTime(int pin, uint8_t offTime, uint8_t offIntensity);
+
+  // LED framebuffer, changes are held until flush()
+  void bufferPWM(int pin, int value);
+  void bufferBrightness(int pin, uint8_t brightness);
+  void bufferOnTime(int pin, uint8_t onTime);
+  void bufferOffTime(int pin, uint8_t offTime, uint8_t offIntensity);
+  void flush();
+
+  // LED effects, run by the on-chip LED engine
+  void breathe(int pin, int onMs, int offMs, int riseMs, int fallMs, uint8_t onIntensity = 255, uint8_t offIntensity = 0);
+  void pulse(int pin, int onMs, int offMs, uint8_t onIntensity = 255, uint8_t offIntensity = 0);
+  void fadeTo(int pin, uint8_t intensity, int ms);
+  void flash(int pin, int onMs, int riseMs = 0, int fallMs = 0, uint8_t onIntensity = 255);
+  void setFadeTime(int pin, uint8_t riseTime, uint8_t fallTime);
+  uint8_t msToOnTime(int ms);
+  uint8_t msToOffTime(int ms);
+  uint8_t msToFadeTime(int ms, uint8_t onIntensity, uint8_t offIntensity);
   
 
   void setDriverMode(bool linear);
@@ -87,8 +157,71 @@ public:
   void disableInterupt(int pin);
   int getInteruptSource(Bank bank);
 
-  int getBank(int pin) { return (pin < 8) ? 1 : 0; };        // for bank A increment all commands by 1, else don't increment
-  int getPinPos(int pin) { return (pin < 8) ? pin : pin - 8; }; // pin bit position
+  // both banks in a single transaction, bits 15:8 == Bank B, bits 7:0 == Bank A (ie. bit position == pin number)
+  void setDirection16(uint16_t inOut);
+  void setPullup16(uint16_t pullups);
+  void setInteruptMask16(uint16_t mask);
+  uint16_t getInteruptSource16();
+  void clearInteruptSource16(uint16_t sources);
+  void setInteruptAutoClear(bool enable);
+
+  // interrupt event engine
+  void enableInteruptEvents(PinName nintPin, EventQueue *queue = mbed_event_queue());
+  void disableInteruptEvents();
+  void attachEventCallback(Callback<void()> func);
+  int serviceInterupt();
+  int serviceInterupt(uint32_t timestamp);
+  bool readEvent(Event *event);
+  int eventsPending();
+
+  // keypad engine
+  void keypad(int rows, int columns, uint8_t scanTime = 0, uint8_t sleepTime = 0);
+  uint16_t readKeyData();
+  bool keypadEnabled() { return (regCache[REG_KEY_CONFIG_2] & 0b00111000) != 0; };
+  static int getKeyIndex(uint16_t keyData);
+  static int getKeyRow(uint16_t keyData);
+  static int getKeyColumn(uint16_t keyData);
+
+  static constexpr int getBank(int pin) { return (pin < 8) ? 1 : 0; };        // for bank A increment all commands by 1, else don't increment
+  static constexpr int getPinPos(int pin) { return (pin < 8) ? pin : pin - 8; }; // pin bit position
+
+  template <int pin>
+  static constexpr int getBank() {
+    static_assert(pin >= 0 && pin < 16, "SX1509 pin out of range");
+    return getBank(pin);
+  };
+
+  template <int pin>
+  static constexpr int getPinPos() {
+    static_assert(pin >= 0 && pin < 16, "SX1509 pin out of range");
+    return getPinPos(pin);
+  };
+
+  /** LED driver register addressing, computed at compile time for constant pins (no RAM lookup tables)
+   * IO[0:3] and IO[8:11] have 3 registers each (RegTOn, RegIOn, RegOff)
+   * IO[4:7] and IO[12:15] have 5 registers each (RegTOn, RegIOn, RegOff, RegTRise, RegTFall)
+  */
+  static constexpr int regTOn(int pin) {
+    return (pin < 4) ? REG_T_ON_0 + (pin * 3)
+         : (pin < 8) ? REG_T_ON_4 + ((pin - 4) * 5)
+         : (pin < 12) ? REG_T_ON_8 + ((pin - 8) * 3)
+         : REG_T_ON_12 + ((pin - 12) * 5);
+  };
+  static constexpr int regIOn(int pin) { return regTOn(pin) + 1; };
+  static constexpr int regOff(int pin) { return regTOn(pin) + 2; };
+  static constexpr int regTRise(int pin) { return regTOn(pin) + 3; }; // fading capable IOs only
+  static constexpr int regTFall(int pin) { return regTOn(pin) + 4; }; // fading capable IOs only
+  static constexpr bool canFade(int pin) { return (pin & 0b0100) != 0; }; // IO[4:7] and IO[12:15]
+
+  // pin-constant versions, ie. io.digitalWrite<3>(1), which fold down to an immediate register address
+  template <int pin>
+  void digitalWrite(int value) { this->regWriteBit(REG_DATA_B + getBank<pin>(), getPinPos<pin>(), value); };
+
+  template <int pin>
+  void setPWM(int value) {
+    static_assert(pin >= 0 && pin < 16, "SX1509 pin out of range");
+    this->ledWrite(regIOn(pin), value);
+  };
 
 private:
 
@@ -118,6 +251,80 @@ private:
 		return commands[0];
 	}
 
+	// read consecutive registers in a single repeated-start burst using register auto-increment
+	inline void i2cReadBurst(char _command, uint8_t *_data, int _length){
+		char commands[1];
+		commands[0] = _command;
+		i2c->write(address, commands, 1, true);
+		i2c->read(address, (char *)_data, _length);
+	}
+
+	// read two consecutive registers (Bank B then Bank A) in a single repeated-start burst using register auto-increment
+	inline uint16_t i2cRead16(char _command){
+		char commands[2];
+		commands[0] = _command;
+		i2c->write(address, commands, 1, true);
+		i2c->read(address, commands, 2);
+		return (commands[0] << 8) | commands[1];
+	}
+
+	// write consecutive registers in a single transaction using register auto-increment
+	inline void i2cWriteBurst(char _command, const uint8_t *_data, int _length){
+		char commands[MAX_BURST_LENGTH + 1];
+		commands[0] = _command;
+		memcpy(&commands[1], _data, _length);
+
+		i2c->write(address, commands, _length + 1);
+	}
+
+	// write a shadowed register, skipping the transaction entirely when the value is unchanged
+	inline void regWrite(int reg, uint8_t value){
+		if (regCache[reg] != value) {
+			regCache[reg] = value;
+			this->i2cWrite(reg, value);
+		}
+	}
+
+	// set or clear a single bit of a shadowed register
+	inline void regWriteBit(int reg, int bit, int value){
+		this->regWrite(reg, bitWrite(regCache[reg], bit, value));
+	}
+
+	// write a shadowed Bank B / Bank A register pair, only sending the bytes which changed
+	inline void regWrite16(int reg, uint16_t value){
+		uint8_t bankB = value >> 8;
+		uint8_t bankA = value & 0xFF;
+		if (regCache[reg] != bankB && regCache[reg + 1] != bankA) {
+			regCache[reg] = bankB;
+			regCache[reg + 1] = bankA;
+			this->i2cWrite(reg, bankB, bankA);
+		} else {
+			this->regWrite(reg, bankB);
+			this->regWrite(reg + 1, bankA);
+		}
+	}
+
+	inline uint16_t regRead16(int reg){
+		return (regCache[reg] << 8) | regCache[reg + 1];
+	}
+
+	// the last value written to a shadowed register (no bus traffic)
+	inline uint8_t regRead(int reg){
+		return regCache[reg];
+	}
+
+	void resetCache();
+	void nintFallCallback();
+	void handleInterupt();
+	bool pushEvent(uint8_t pin, EventType type, uint32_t timestamp);
+	void regWriteBurst(int reg, const uint8_t *values, int count);
+	void ledBuffer(int reg, uint8_t value);
+	void ledWrite(int reg, uint8_t value);
+	void ledFlushRange(int reg, int count);
+	void ledEffect(int pin, uint8_t onTime, uint8_t onIntensity, uint8_t offTime, uint8_t offIntensity, uint8_t riseTime, uint8_t fallTime);
+	uint32_t ledTick();
+	static uint8_t nearestTime(uint32_t target, uint32_t lowStep, uint32_t highStep);
+
   enum DriverMode
   {
     LINEAR = 0b00000000,
@@ -250,6 +457,28 @@ private:
     REG_TEST_2 = 0x7F, //	RegTest2 Test register 0000 0000
   };
 
+  /** Register shadow cache
+   * Holds the last written value of every writable register from REG_INPUT_DISABLE_B through REG_KEY_CONFIG_2.
+   * Entries for read-only / write-to-clear registers (RegInterruptSource, RegEventStatus) are unused.
+   * RegData entries hold the output latch, not the pin state, so digitalRead() still goes to the bus.
+  */
+  static const int REG_CACHE_SIZE = REG_KEY_CONFIG_2 + 1;
+  static const int MAX_BURST_LENGTH = 64;
+
+  /** LED driver register shadow (RegTOn0 -> RegTFall15), one dirty bit per register */
+  static const int LED_FRAME_SIZE = REG_T_FALL_15 - REG_T_ON_0 + 1;
+  static const int LED_FLUSH_MAX_GAP = 2;
+  uint8_t ledFrame[LED_FRAME_SIZE];
+  uint64_t ledDirty;
+
+  // single producer (eventQueue) / single consumer (application) lock-free ring buffer
+  Event eventBuffer[SX1509_EVENT_QUEUE_SIZE];
+  volatile uint8_t eventHead;
+  volatile uint8_t eventTail;
+  volatile uint32_t nintTimestamp;
+  int nintRetries;                 // re-services of NINT without it being released
+  uint8_t regCache[REG_CACHE_SIZE];
+
 }; // end of class
 
 #endif
@@ -0,0 +1,161 @@
+#include "SX1509Array.h"
+
+/**
+ * returns the state of every IO, the chips are read back-to-back with one burst each
+*/
+uint64_t SX1509Array::read()
+{
+  uint64_t data = 0;
+  for (int i = 0; i < numChips; i++)
+  {
+    data |= (uint64_t)chips[i]->read16() << (i * 16);
+  }
+  return data;
+}
+
+/**
+ * write all IOs, only chips whose RegData shadow changes are written
+*/
+void SX1509Array::write(uint64_t data)
+{
+  for (int i = 0; i < numChips; i++)
+  {
+    chips[i]->write16((data >> (i * 16)) & 0xFFFF);
+  }
+}
+
+/**
+ * pins outside 0 -> numPins() - 1 are ignored
+*/
+void SX1509Array::digitalWrite(int pin, int value)
+{
+  if (pin < 0 || pin >= numPins()) {
+    return;
+  }
+  chips[pin / 16]->digitalWrite(pin % 16, value);
+}
+
+/**
+ * pins outside 0 -> numPins() - 1 read as 0
+*/
+int SX1509Array::digitalRead(int pin)
+{
+  if (pin < 0 || pin >= numPins()) {
+    return 0;
+  }
+  return chips[pin / 16]->digitalRead(pin % 16);
+}
+
+/**
+ * flush the LED framebuffer of every chip (chips with nothing dirty are skipped)
+*/
+void SX1509Array::flush()
+{
+  for (int i = 0; i < numChips; i++)
+  {
+    chips[i]->flush();
+  }
+}
+
+/** Shared Interrupt Line
+ * 
+ * All NINT outputs are open drain and can be wired together onto one MCU pin. On a falling edge every chip
+ * is serviced from the EventQueue, each decoding its own interrupt sources. Chips with no unmasked IO
+ * interrupt (and no keypad) are skipped without touching the bus.
+*/
+void SX1509Array::enableInteruptEvents(PinName nintPin, EventQueue *queue /*mbed_event_queue()*/)
+{
+  if (nint == NULL) {
+    nint = new InterruptIn(nintPin, PullUp);
+  }
+  eventQueue = queue;
+  nint->fall(callback(this, &SX1509Array::nintFallCallback));
+
+  for (int i = 0; i < numChips; i++)
+  {
+    chips[i]->setInteruptAutoClear(false); // see SX1509::enableInteruptEvents()
+    chips[i]->clearInteruptSource16(0xFFFF);
+  }
+}
+
+void SX1509Array::disableInteruptEvents()
+{
+  if (nint != NULL) {
+    delete nint;
+    nint = NULL;
+  }
+  for (int i = 0; i < numChips; i++)
+  {
+    chips[i]->setInteruptAutoClear(true);
+  }
+}
+
+/**
+ * to attach a function     -->   attachEventCallback(&myFunc)
+ * to attach a class method -->   attachEventCallback(callback(this, &MyClass::myClassMethod))
+*/
+void SX1509Array::attachEventCallback(Callback<void()> func)
+{
+  eventCallback = func;
+}
+
+void SX1509Array::nintFallCallback()
+{
+  nintTimestamp = us_ticker_read();
+  eventQueue->call(callback(this, &SX1509Array::handleInterupt));
+}
+
+/**
+ * re-serviced while NINT is still asserted by at least one chip, up to SX1509_NINT_MAX_RETRIES passes that queue nothing
+*/
+void SX1509Array::handleInterupt()
+{
+  int count = this->serviceInterupt();
+  if (nint == NULL || nint->read() != 0) {
+    nintRetries = 0;
+    return;
+  }
+  nintRetries = count ? 0 : nintRetries + 1;
+  if (nintRetries < SX1509_NINT_MAX_RETRIES) {
+    eventQueue->call(callback(this, &SX1509Array::handleInterupt));
+  } else {
+    nintRetries = 0;
+  }
+}
+
+/**
+ * returns the number of events queued across all chips
+*/
+int SX1509Array::serviceInterupt()
+{
+  int count = 0;
+  uint32_t timestamp = nintTimestamp;
+  for (int i = 0; i < numChips; i++)
+  {
+    count += chips[i]->serviceInterupt(timestamp);
+  }
+
+  if (count && eventCallback) {
+    eventCallback();
+  }
+  return count;
+}
+
+/**
+ * pops the next queued event of any chip, with event->pin offset into the 64 IO space (chip * 16 + pin),
+ * or for KEY_PRESS events into the key space (chip * 64 + key index).
+ * Chips are visited round robin so a busy chip can not starve the others.
+*/
+bool SX1509Array::readEvent(SX1509::Event *event)
+{
+  for (int i = 0; i < numChips; i++)
+  {
+    int chip = (nextChip + i) % numChips;
+    if (chips[chip]->readEvent(event)) {
+      event->pin += chip * ((event->type == SX1509::KEY_PRESS) ? 64 : 16); // key indexes span 0..63 per chip
+      nextChip = (chip + 1) % numChips;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,65 @@
+#ifndef _SX1509_ARRAY_H_
+#define _SX1509_ARRAY_H_
+
+#include <mbed.h>
+#include "SX1509.h"
+
+#define SX1509_ARRAY_MAX_CHIPS  4
+
+/**
+ * Presents up to four SX1509s on one bus (ex. 0x3E, 0x3F, 0x70, 0x71) as a single 64 IO bitmap.
+ * IO[n] of chips[i] --> bit (i * 16) + n
+ * 
+ * Writes go through each chip's register shadow, so chips whose state did not change see no bus traffic.
+*/
+class SX1509Array {
+public:
+  SX1509Array(SX1509 *chip0, SX1509 *chip1 = NULL, SX1509 *chip2 = NULL, SX1509 *chip3 = NULL) {
+    SX1509 *_chips[SX1509_ARRAY_MAX_CHIPS] = { chip0, chip1, chip2, chip3 };
+    numChips = 0;
+    for (int i = 0; i < SX1509_ARRAY_MAX_CHIPS; i++)
+    {
+      chips[i] = NULL;
+    }
+    for (int i = 0; i < SX1509_ARRAY_MAX_CHIPS; i++)
+    {
+      if (_chips[i] != NULL) {
+        chips[numChips++] = _chips[i];
+      }
+    }
+    nint = NULL;
+    eventQueue = NULL;
+    nextChip = 0;
+    nintRetries = 0;
+  };
+
+  SX1509 *chips[SX1509_ARRAY_MAX_CHIPS];
+  int numChips;
+  InterruptIn *nint;               // shared (wire-OR'd) NINT line of all chips
+  EventQueue *eventQueue;
+  Callback<void()> eventCallback;
+
+  uint64_t read();
+  void write(uint64_t data);
+  void digitalWrite(int pin, int value);
+  int digitalRead(int pin);
+  void flush();
+
+  void enableInteruptEvents(PinName nintPin, EventQueue *queue = mbed_event_queue());
+  void disableInteruptEvents();
+  void attachEventCallback(Callback<void()> func);
+  int serviceInterupt();
+  bool readEvent(SX1509::Event *event);
+
+  int numPins() { return numChips * 16; };
+
+private:
+  void nintFallCallback();
+  void handleInterupt();
+
+  volatile uint32_t nintTimestamp;
+  int nextChip;                    // round robin position of readEvent()
+  int nintRetries;                 // re-services of NINT without it being released
+};
+
+#endif
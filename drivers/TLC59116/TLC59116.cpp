@@ -4,7 +4,7 @@ void TLC59116::initialize() {
   setMode(0b00000000, 0b00000000);
   
   // IREF affects the voltage at the REXT terminal and indirectly the reference current (Iref) flowing through the external resistor at terminal REXT
-  writeRegister(IREF, 0xC0); // set voltage gain to 0.5 (default: 0.992)
+  setVoltageGain(0xC0); // set voltage gain to 0.5 (default: 0.992)
 
   writeRegister(GRPPWM, 0x00);
   writeRegister(GRPFREQ, 0x00);
@@ -102,6 +102,7 @@ void TLC59116::setLedOutput(int led, LedState state, int pwm /*=0*/) {
   if (state == LedState::PWM) {
     setLedPWM(led, pwm);
   }
+  applyPowerBudget();
 }
 
 
@@ -110,17 +111,73 @@ void TLC59116::setLedOutput(int led, LedState state, int pwm /*=0*/) {
  * ex. 1111 1111 1111 1111 == 65535 == all LEDs ON
 */
 void TLC59116::setLedOutput16(uint16_t value) {
+  // spread the 16 bits out to every other bit, so LED x lands on bits 2x+1:2x as 01 (ON) or 00 (OFF)
+  uint32_t states = value;
+  states = (states | (states << 8)) & 0x00FF00FF;
+  states = (states | (states << 4)) & 0x0F0F0F0F;
+  states = (states | (states << 2)) & 0x33333333;
+  states = (states | (states << 1)) & 0x55555555;
+
+  uint8_t ledOut[4];
+  ledOut[0] = states & 0xFF;
+  ledOut[1] = (states >> 8) & 0xFF;
+  ledOut[2] = (states >> 16) & 0xFF;
+  ledOut[3] = (states >> 24) & 0xFF;
+  writeLedOutputs(ledOut);
 }
 
+/**
+ * sets the output state (OFF, ON, PWM, GROUP) of all 16 LEDs at once, index == LED number
+*/
+void TLC59116::setLedStates(const LedState states[16]) {
+  uint8_t ledOut[4] = { 0, 0, 0, 0 };
+  for (int led = 0; led < 16; led++) {
+    ledOut[led / 4] |= (states[led] & 0b11) << ((led % 4) * 2);
+  }
+  writeLedOutputs(ledOut);
+}
 
 /**
- * write a function which will get called after (or before) every I2C transfer to determine how many LEDs
- * are going to be turned on, and have it determing the appropriate voltage gain to power those leds.
- * Class initialization will take an additional argument informing the "max power" usage to be used. This
- * value will be used as a "ceiling"
+ * Bi-color LEDs are wired as pairs of outputs, pair N --> LED 2N (color A) and LED 2N + 1 (color B)
  * 
- * basically the more LEDs lit, the dimmer they become.
-*/ 
+ * mix: 0 == only color A, 255 == only color B, in between the brightness is split across both colors
+ * mix and brightness are clamped to 0 - 255
+ * 
+ * Both PWM values and the LEDOUT register holding the pair are sent in one auto-increment write
+ * (PWM[2N] -> LEDOUTx), with the registers in between re-sent from the frame, so a color change never
+ * shows an intermediate color.
+*/
+void TLC59116::setBiColorLedOutput(int pair, int mix, int brightness /*=255*/) {
+  if (pair < 0 || pair > 7) {
+    return;
+  }
+  mix = mix < 0 ? 0 : (mix > 255 ? 255 : mix);
+  brightness = brightness < 0 ? 0 : (brightness > 255 ? 255 : brightness);
+
+  int led = pair * 2;
+  int ledOutReg = LEDOUT0 + led / 4;
+  int shift = (led % 4) * 2;
+
+  uint8_t states = frame[ledOutReg - FRAME_START];
+  states &= ~(0b1111 << shift);
+  states |= ((PWM << 2) | PWM) << shift;
+
+  frame[pwmRegisters[led] - FRAME_START] = brightness * (255 - mix) / 255;
+  frame[pwmRegisters[led + 1] - FRAME_START] = brightness * mix / 255;
+  frameShadow(ledOutReg, &states, 1);
+
+  writeRegisters(pwmRegisters[led], &frame[pwmRegisters[led] - FRAME_START], ledOutReg - pwmRegisters[led] + 1);
+  applyPowerBudget();
+}
+
+/**
+ * LEDOUT0 -> LEDOUT3 in a single 4 byte auto-increment transaction
+*/
+void TLC59116::writeLedOutputs(const uint8_t ledOut[4]) {
+  writeRegisters(LEDOUT0, ledOut, 4);
+  applyPowerBudget();
+}
+
 
 /**
  * A 97-kHz fixed frequency signal is used for each output.
@@ -130,6 +187,203 @@ void TLC59116::setLedOutput16(uint16_t value) {
 */ 
 void TLC59116::setLedPWM(int led, int value) {
   writeRegister(pwmRegisters[led], value);
+  applyPowerBudget();
+}
+
+/**
+ * perceptual brightness (0 - 255), gamma corrected through a compile-time table before being written as PWM
+*/
+void TLC59116::setBrightness(int led, uint8_t brightness) {
+  setLedPWM(led, gammaCorrect<TLC59116_GAMMA>(brightness));
+}
+
+/**
+ * Write all 16 PWM registers (PWM0 -> PWM15) in a single 17 byte auto-increment transaction.
+ * Only LEDs whose LEDOUT state is PWM or GROUP are affected by their PWM value.
+*/
+void TLC59116::writeFrame(const uint8_t pwm[16]) {
+  writeRegisters(PWM0, pwm, 16, AUTO_INCREMENT_PWM);
+  applyPowerBudget();
+}
+
+/**
+ * Partial frame update, writes PWM[firstLed] -> PWM[firstLed + count - 1] in a single transaction
+*/
+void TLC59116::writeFrame(int firstLed, int count, const uint8_t *pwm) {
+  if (firstLed < 0 || count <= 0 || firstLed + count > 16) {
+    return;
+  }
+  writeRegisters(pwmRegisters[firstLed], pwm, count, AUTO_INCREMENT_PWM);
+  applyPowerBudget();
+}
+
+
+/**
+ * Framebuffer
+ * buffer*() only update the frame and widen the dirty register span, so repeated writes to the same
+ * register between flushes are merged. flush() then sends the dirty span (anywhere within PWM0 -> LEDOUT3)
+ * as a single auto-increment burst.
+*/
+void TLC59116::bufferLedPWM(int led, int value) {
+  if (led < 0 || led > 15) {
+    return;
+  }
+  frameBuffer(pwmRegisters[led], value);
+}
+
+void TLC59116::bufferBrightness(int led, uint8_t brightness) {
+  bufferLedPWM(led, gammaCorrect<TLC59116_GAMMA>(brightness));
+}
+
+void TLC59116::bufferLedOutput(int led, LedState state) {
+  if (led < 0 || led > 15) {
+    return;
+  }
+  int reg = LEDOUT0 + led / 4;
+  int shift = (led % 4) * 2;
+  uint8_t states = frame[reg - FRAME_START];
+  states &= ~(0b11 << shift);
+  states |= state << shift;
+  frameBuffer(reg, states);
+}
+
+void TLC59116::bufferGroupPWM(int value) {
+  frameBuffer(GRPPWM, value);
+}
+
+void TLC59116::bufferGroupFREQ(int value) {
+  frameBuffer(GRPFREQ, value);
+}
+
+/**
+ * max number of flushes per second performed by poll(). A value of 0 flushes on every call to poll()
+*/
+void TLC59116::setFrameRate(int hz) {
+  framePeriod = hz > 0 ? 1000000 / hz : 0;
+}
+
+/**
+ * call from the main loop, flushes the frame once a frame period has passed since it was first changed
+*/
+void TLC59116::poll() {
+  if (dirtyStart < 0) {
+    return;
+  }
+  if (framePeriod == 0 || us_ticker_read() - frameStart >= (uint32_t)framePeriod) {
+    flush();
+  }
+}
+
+void TLC59116::flush() {
+  if (dirtyStart < 0) {
+    return;
+  }
+  int start = dirtyStart;
+  int length = dirtyEnd - dirtyStart + 1;
+  dirtyStart = -1;
+  writeRegisters(start, &frame[start - FRAME_START], length);
+  applyPowerBudget();
+}
+
+/**
+ * Power budgeting
+ * After every flush (and every immediate PWM / LEDOUT write) the total duty of the frame is compared against the power budget, and when the load exceeds it
+ * the voltage gain (IREF) is scaled down proportionally from the ceiling set by setVoltageGain().
+ * basically the more LEDs lit, the dimmer they become. IREF is only written when the resulting gain step changes.
+*/
+void TLC59116::setPowerBudget(int budget) {
+  powerBudget = budget;
+  applyPowerBudget();
+}
+
+/**
+ * sum of all 16 output duty cycles, 255 == one LED fully ON
+ * GROUP outputs are counted at their PWM value, as GRPPWM can only dim them further
+*/
+int TLC59116::getFrameLoad() {
+  int load = 0;
+  for (int led = 0; led < 16; led++) {
+    int state = (frame[LEDOUT0 + led / 4 - FRAME_START] >> ((led % 4) * 2)) & 0b11;
+    if (state == ON) {
+      load += 255;
+    } else if (state == PWM || state == GROUP) {
+      load += frame[PWM0 + led - FRAME_START];
+    }
+  }
+  return load;
+}
+
+void TLC59116::applyPowerBudget() {
+  int gain = voltageGain;
+  if (powerBudget > 0) {
+    int load = getFrameLoad();
+    if (load > powerBudget * 255) {
+      gain = vgToGain(gainToVG(voltageGain) * powerBudget * 255 / load, bitRead(voltageGain, 7));
+    }
+  }
+  if (gain != currentGain) {
+    currentGain = gain;
+    writeRegister(IREF, gain);
+  }
+}
+
+/**
+ * largest IREF value with a voltage gain (VG * 256) not above vg
+*/
+int TLC59116::vgToGain(int vg, int cm) {
+  int gain = cm << 7;
+  if (vg >= 128) {
+    int d = vg / 2 - 64;
+    gain |= 0x40 | (d > 63 ? 63 : d);
+  } else if (vg > 64) {
+    gain |= vg - 64;
+  }
+  return gain;
+}
+
+void TLC59116::resetFrame() {
+  memset(frame, 0, FRAME_SIZE); // power-up defaults
+  frame[GRPPWM - FRAME_START] = 0xFF;
+  led0States = 0x00;
+  led1States = 0x00;
+  led2States = 0x00;
+  led3States = 0x00;
+  dirtyStart = -1;
+  dirtyEnd = -1;
+  frameStart = 0;
+}
+
+void TLC59116::frameBuffer(int reg, uint8_t value) {
+  if (frame[reg - FRAME_START] == value) {
+    return;
+  }
+  frameShadow(reg, &value, 1);
+  if (dirtyStart < 0) {
+    dirtyStart = reg;
+    dirtyEnd = reg;
+    frameStart = us_ticker_read(); // frame period counts from the first change
+  } else {
+    dirtyStart = reg < dirtyStart ? reg : dirtyStart;
+    dirtyEnd = reg > dirtyEnd ? reg : dirtyEnd;
+  }
+}
+
+/**
+ * keep the frame (and LEDOUT state members) in sync with whatever is written to PWM0 -> LEDOUT3
+*/
+void TLC59116::frameShadow(int reg, const uint8_t *data, int length) {
+  for (int i = 0; i < length; i++, reg++) {
+    if (reg < FRAME_START || reg >= FRAME_START + FRAME_SIZE) {
+      continue;
+    }
+    frame[reg - FRAME_START] = data[i];
+    switch (reg) {
+      case LEDOUT0: led0States = data[i]; break;
+      case LEDOUT1: led1States = data[i]; break;
+      case LEDOUT2: led2States = data[i]; break;
+      case LEDOUT3: led3States = data[i]; break;
+    }
+  }
 }
 
 
@@ -176,31 +430,25 @@ void TLC59116::setMode(int mode1Value, int mode2Value) {
  * 
  * IREF affects the voltage at the REXT terminal and indirectly the reference current (Iref) 
  * flowing through the external resistor at terminal REXT
+ * 
+ * | CM | HC | D5 | D4 | D3 | D2 | D1 | D0 |
+ * VG = (1 + HC) * (1 + D/64) / 4  --> 0xC0 == 0.5, 0xFF == 0.992 (default)
+ * 
+ * With a power budget set, this is the ceiling the gain is scaled down from.
 */
 void TLC59116::setVoltageGain(int gain) {
-  writeRegister(IREF, 0xC0); // set voltage gain to 0.5 (default: 0.992)
+  voltageGain = gain;
+  currentGain = gain;
+  writeRegister(IREF, gain);
+  applyPowerBudget();
 }
 
 void TLC59116::setAllOutputsLow() {
-  led0States = 0x00;
-  led1States = 0x00;
-  led2States = 0x00;
-  led3States = 0x00;
-  writeRegister(LEDOUT0, 0x00);
-  writeRegister(LEDOUT1, 0x00);
-  writeRegister(LEDOUT2, 0x00);
-  writeRegister(LEDOUT3, 0x00);
+  setLedOutput16(0x0000);
 }
 
 void TLC59116::setAllOutputsHigh() {
-  led0States = 0x11;
-  led1States = 0x11;
-  led2States = 0x11;
-  led3States = 0x11;
-  writeRegister(LEDOUT0, 0x11);
-  writeRegister(LEDOUT1, 0x11);
-  writeRegister(LEDOUT2, 0x11);
-  writeRegister(LEDOUT3, 0x11);
+  setLedOutput16(0xFFFF);
 }
 
 void TLC59116::enableDimmingMode() {
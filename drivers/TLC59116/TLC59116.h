@@ -3,11 +3,18 @@
 
 #include "mbed.h"
 #include "BitwiseMethods.h"
+#include "GammaTable.h"
 
-#define TLC59116_DEFAULT_ADDR   1100000
-#define TLC59116_ALL_CALL       1101000
+#define TLC59116_DEFAULT_ADDR   0x60      // 110 0000, A3:A0 == 0
+#define TLC59116_ALL_CALL       0x68      // 110 1000, power-up ALLCALLADR (requires MODE1 ALLCALL bit)
+#define TLC59116_FRAME_RATE     60        // default framebuffer flush rate (Hz) used by poll()
+
+#ifndef TLC59116_GAMMA
+#define TLC59116_GAMMA          GAMMA_DEFAULT  // exponent * 100 used by setBrightness()
+#endif
 
 class TLC59116 {
+  friend class TLC59116Group;
 public:
   
   enum LedState {
@@ -17,9 +24,17 @@ public:
     GROUP = 3,  // LED individual brightness and group dimming/blinking can be controlled through its PWMx register and the GRPPWM registers
   };
 
-  TLC59116(I2C * _i2c, int _address = TLC59116_DEFAULT_ADDR) {
+  /**
+   * @param _powerBudget max load, in number of LEDs fully ON at the voltage gain set by setVoltageGain(). 0 == no limit
+  */
+  TLC59116(I2C * _i2c, int _address = TLC59116_DEFAULT_ADDR, int _powerBudget = 0) {
     i2c = _i2c;
     address = _address << 1;
+    powerBudget = _powerBudget;
+    voltageGain = 0xFF; // IREF power-up default
+    currentGain = 0xFF;
+    resetFrame();
+    setFrameRate(TLC59116_FRAME_RATE);
   };
   
   int address;
@@ -35,18 +50,34 @@ public:
   void enableBlinkingMode();
   void setMode(int mode1Value, int mode2Value);
   void setVoltageGain(int gain);
+  void setPowerBudget(int budget);
   void setLedOutput(int led, LedState state, int pwm=0);
   void setLedOutput16(uint16_t value);
-  void setBiColorLedOutput(int pins, int state);
+  void setLedStates(const LedState states[16]);
+  void setBiColorLedOutput(int pair, int mix, int brightness = 255);
   void setLedPWM(int led, int value);
+  void setBrightness(int led, uint8_t brightness);
+  void writeFrame(const uint8_t pwm[16]);
+  void writeFrame(int firstLed, int count, const uint8_t *pwm);
   void setGroupPWM(int value);
   void setGroupFREQ(int value);
   void setAllOutputsLow();
   void setAllOutputsHigh();
 
+  // framebuffer, changes are held until flush() or the next poll() after a frame period has elapsed
+  void bufferLedPWM(int led, int value);
+  void bufferBrightness(int led, uint8_t brightness);
+  void bufferLedOutput(int led, LedState state);
+  void bufferGroupPWM(int value);
+  void bufferGroupFREQ(int value);
+  void setFrameRate(int hz);
+  void poll();
+  void flush();
+
 private:
     
   void writeRegister(char reg, char data) {    
+    frameShadow(reg, (const uint8_t *)&data, 1);
     char buffer[2];
     buffer[0] = reg;
     buffer[1] = data;
@@ -55,6 +86,26 @@ private:
     // i2c->stop();
   }
 
+  // write consecutive registers in a single transaction, using the control register auto-increment bits
+  void writeRegisters(char reg, const uint8_t *data, int length, char autoIncrement = AUTO_INCREMENT_ALL) {
+    frameShadow(reg, data, length);
+    char buffer[MAX_REGISTERS + 1];
+    buffer[0] = autoIncrement | reg;
+    memcpy(&buffer[1], data, length);
+    i2c->write(address, buffer, length + 1);
+  }
+
+  void writeLedOutputs(const uint8_t ledOut[4]);
+  void resetFrame();
+  void frameBuffer(int reg, uint8_t value);
+  void frameShadow(int reg, const uint8_t *data, int length);
+  int getFrameLoad();
+  void applyPowerBudget();
+
+  // IREF --> | CM | HC | D5:D0 |, VG = (1 + HC) * (1 + D/64) / 4
+  static int gainToVG(int gain) { return (1 + bitRead(gain, 6)) * (64 + (gain & 0x3F)); } // VG * 256
+  static int vgToGain(int vg, int cm);
+
   char readRegister(char reg) {
     char command[1];
     char buffer[1];
@@ -98,6 +149,32 @@ private:
     EFLAG2 = 0x1E, // R Error flags 2
   };
 
+  static const int MAX_REGISTERS = EFLAG2 + 1;
+
+  /** Control Register auto-increment flags (bits 7:5 --> AI2 AI1 AI0)
+   * The register address rolls over within the selected range
+  */
+  enum AutoIncrement {
+    AUTO_INCREMENT_NONE = 0x00,
+    AUTO_INCREMENT_ALL = 0x80,        // 00h -> 1Eh
+    AUTO_INCREMENT_PWM = 0xA0,        // PWM0 -> PWM15
+    AUTO_INCREMENT_GLOBAL = 0xC0,     // GRPPWM -> GRPFREQ
+    AUTO_INCREMENT_PWM_GLOBAL = 0xE0, // PWM0 -> GRPFREQ
+  };
+
+  // shadow of PWM0 -> LEDOUT3 as last written (or buffered), plus the dirty register span awaiting flush()
+  static const int FRAME_START = PWM0;
+  static const int FRAME_SIZE = LEDOUT3 - PWM0 + 1;
+  uint8_t frame[FRAME_SIZE];
+  int dirtyStart;       // first dirty register, -1 when the frame is clean
+  int dirtyEnd;         // last dirty register
+  uint32_t frameStart;  // us_ticker_read() of the first change to a clean frame (no Timer, so deep sleep isn't locked)
+  int framePeriod;      // us between flushes in poll(), 0 == flush on every poll()
+
+  int powerBudget;      // 0 == disabled
+  uint8_t voltageGain;  // IREF value set by setVoltageGain(), the ceiling for the power budget
+  uint8_t currentGain;  // IREF value currently in the device
+
   char pwmRegisters[16] = { PWM0, PWM1, PWM2, PWM3, PWM4, PWM5, PWM6, PWM7, PWM8, PWM9, PWM10, PWM11, PWM12, PWM13, PWM14, PWM15 };
 };
 
@@ -0,0 +1,85 @@
+#include "TLC59116Group.h"
+
+/**
+ * Each chip is initialized individually, as ALL_CALL is only answered once the MODE1 ALLCALL bit is set
+*/
+void TLC59116Group::initialize() {
+  for (int i = 0; i < numChips; i++) {
+    chips[i]->initialize();
+  }
+  for (int i = 0; i < numChips; i++) {
+    chips[i]->setMode(0b00000001, 0b00000000);
+  }
+}
+
+/**
+ * ALLCALL (MODE1 bit 0) is always kept set, otherwise the chips would stop responding to the group
+*/
+void TLC59116Group::setMode(int mode1Value, int mode2Value) {
+  broadcast.setMode(mode1Value | 0b00000001, mode2Value);
+}
+
+void TLC59116Group::setVoltageGain(int gain) {
+  broadcast.writeRegister(TLC59116::IREF, gain);
+  for (int i = 0; i < numChips; i++) {
+    chips[i]->voltageGain = gain;
+    chips[i]->currentGain = gain;
+    chips[i]->applyPowerBudget(); // only chips over their budget get an individual IREF write
+  }
+}
+
+void TLC59116Group::setGroupPWM(int value) {
+  uint8_t data = value;
+  broadcastRegisters(TLC59116::GRPPWM, &data, 1);
+}
+
+void TLC59116Group::setGroupFREQ(int value) {
+  uint8_t data = value;
+  broadcastRegisters(TLC59116::GRPFREQ, &data, 1);
+}
+
+void TLC59116Group::setAllOutputsLow() {
+  const uint8_t ledOut[4] = { 0x00, 0x00, 0x00, 0x00 };
+  broadcastRegisters(TLC59116::LEDOUT0, ledOut, 4);
+}
+
+void TLC59116Group::setAllOutputsHigh() {
+  const uint8_t ledOut[4] = { 0x55, 0x55, 0x55, 0x55 };
+  broadcastRegisters(TLC59116::LEDOUT0, ledOut, 4);
+}
+
+/**
+ * max number of flushes per second performed by poll(). A value of 0 flushes on every call to poll()
+*/
+void TLC59116Group::setFrameRate(int hz) {
+  framePeriod = hz > 0 ? 1000000 / hz : 0;
+}
+
+void TLC59116Group::poll() {
+  if (framePeriod == 0 || us_ticker_read() - lastFlush >= (uint32_t)framePeriod) {
+    flush();
+  }
+}
+
+/**
+ * flush every chip's dirty span back-to-back, holding the bus so no other transfer lands in between
+*/
+void TLC59116Group::flush() {
+  i2c->lock();
+  for (int i = 0; i < numChips; i++) {
+    chips[i]->flush();
+  }
+  i2c->unlock();
+  lastFlush = us_ticker_read();
+}
+
+/**
+ * one write to the ALL_CALL address, then keep each chip's frame in sync with what it just received
+*/
+void TLC59116Group::broadcastRegisters(int reg, const uint8_t *data, int length) {
+  broadcast.writeRegisters(reg, data, length);
+  for (int i = 0; i < numChips; i++) {
+    chips[i]->frameShadow(reg, data, length);
+    chips[i]->applyPowerBudget();
+  }
+}
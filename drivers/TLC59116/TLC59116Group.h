@@ -0,0 +1,54 @@
+#ifndef __TLC59116_GROUP_H
+#define __TLC59116_GROUP_H
+
+#include "mbed.h"
+#include "TLC59116.h"
+
+#define TLC59116_GROUP_MAX_CHIPS  14   // 0x60 -> 0x6F, less ALL_CALL (0x68) and SWRST (0x6B)
+
+/**
+ * Drives several TLC59116s on one bus as a single panel.
+ * 
+ * Shared settings (mode, GRPPWM, GRPFREQ, IREF, all on / all off) are sent once to the ALL_CALL address, which every
+ * chip with the MODE1 ALLCALL bit set responds to, and then mirrored into each chip's register shadow.
+ * Per-chip frames are flushed back-to-back while holding the bus, so the whole panel updates within one bus window.
+*/
+class TLC59116Group {
+public:
+  TLC59116Group(I2C *_i2c, TLC59116 *_chips[], int count) : broadcast(_i2c, TLC59116_ALL_CALL) {
+    i2c = _i2c;
+    numChips = 0;
+    for (int i = 0; i < count && numChips < TLC59116_GROUP_MAX_CHIPS; i++) {
+      if (_chips[i] != NULL) {
+        chips[numChips++] = _chips[i];
+      }
+    }
+    setFrameRate(TLC59116_FRAME_RATE);
+    lastFlush = 0;
+  };
+
+  I2C *i2c;
+  TLC59116 broadcast;                   // writes through this instance reach every chip at once
+  TLC59116 *chips[TLC59116_GROUP_MAX_CHIPS];
+  int numChips;
+
+  void initialize();
+  void setMode(int mode1Value, int mode2Value);
+  void setVoltageGain(int gain);
+  void setGroupPWM(int value);
+  void setGroupFREQ(int value);
+  void setAllOutputsLow();
+  void setAllOutputsHigh();
+
+  void setFrameRate(int hz);
+  void poll();
+  void flush();
+
+private:
+  void broadcastRegisters(int reg, const uint8_t *data, int length);
+
+  uint32_t lastFlush;   // us_ticker_read() of the last flush (no Timer, so deep sleep isn't locked)
+  int framePeriod;      // us between flushes in poll(), 0 == flush on every poll()
+};
+
+#endif
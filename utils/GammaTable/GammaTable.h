@@ -0,0 +1,95 @@
+#ifndef __GAMMA_TABLE_H
+#define __GAMMA_TABLE_H
+
+#include <stdint.h>
+
+#define GAMMA_DEFAULT   220     // perceptual exponent * 100 (2.2)
+
+/**
+ * Compile-time gamma correction table
+ * 
+ * out[i] = round(((1 << BITS) - 1) * (i / 255) ^ (GAMMA / 100))
+ * 
+ * The whole table is generated by the compiler (C++14 constexpr), so at runtime a perceptual brightness
+ * lookup is a single array read with no floating point math.
+ * 
+ * ex.  uint16_t duty = gammaCorrect<220, 12>(brightness);
+*/
+template<int GAMMA_X100 = GAMMA_DEFAULT, int BITS = 8>
+class GammaTable {
+public:
+  static_assert(GAMMA_X100 > 0, "gamma must be positive");
+  static_assert(BITS > 0 && BITS <= 16, "output must fit in 16 bits");
+
+  constexpr GammaTable() : values() {
+    for (int i = 0; i < 256; i++) {
+      values[i] = correct(i);
+    }
+  }
+
+  constexpr uint16_t operator[](int i) const { return values[i]; }
+
+private:
+  uint16_t values[256];
+
+  static constexpr double LN2 = 0.69314718055994530942;
+
+  // ln(x) for 0 < x <= 1, reduced to m * 2^-k with m in [0.5, 1) then ln(m) = 2 * atanh((m - 1) / (m + 1))
+  static constexpr double ln(double x) {
+    int k = 0;
+    while (x < 0.5) {
+      x *= 2;
+      k++;
+    }
+    double z = (x - 1) / (x + 1);
+    double z2 = z * z;
+    double term = z;
+    double sum = 0;
+    for (int n = 1; n < 40; n += 2) {
+      sum += term / n;
+      term *= z2;
+    }
+    return 2 * sum - k * LN2;
+  }
+
+  // exp(y) for y <= 0, halved until |y| < 0.5, taylor series, then squared back up
+  static constexpr double exp(double y) {
+    int k = 0;
+    while (y < -0.5) {
+      y /= 2;
+      k++;
+    }
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 20; n++) {
+      term *= y / n;
+      sum += term;
+    }
+    while (k-- > 0) {
+      sum *= sum;
+    }
+    return sum;
+  }
+
+  static constexpr uint16_t correct(int i) {
+    const double max = (1 << BITS) - 1;
+    if (i == 0) {
+      return 0;
+    }
+    if (i == 255) {
+      return max;
+    }
+    return exp(ln(i / 255.0) * GAMMA_X100 / 100.0) * max + 0.5;
+  }
+};
+
+/**
+ * 8 bit brightness --> gamma corrected duty cycle of BITS bits
+*/
+template<int GAMMA_X100 = GAMMA_DEFAULT, int BITS = 8>
+inline uint16_t gammaCorrect(uint8_t value) {
+  static constexpr GammaTable<GAMMA_X100, BITS> table;
+  return table[value];
+}
+
+#endif
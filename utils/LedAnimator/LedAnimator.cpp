@@ -0,0 +1,118 @@
+#include "LedAnimator.h"
+
+/**
+ * copy a track of keyframes into the channel and start playing it from the channel's current value
+*/
+void LedAnimator::setTrack(int channel, const Keyframe *keyframes, int count, bool loop /*=false*/) {
+  if (channel < 0 || channel >= LED_ANIMATOR_MAX_CHANNELS || count <= 0) {
+    return;
+  }
+  Track *track = &tracks[channel];
+  track->running = false;
+  track->count = count > LED_ANIMATOR_MAX_KEYFRAMES ? LED_ANIMATOR_MAX_KEYFRAMES : count;
+  memcpy(track->keyframes, keyframes, track->count * sizeof(Keyframe));
+  track->loop = loop;
+  track->index = 0;
+  loadKeyframe(track);
+  track->running = true;
+}
+
+void LedAnimator::stop(int channel) {
+  if (channel < 0 || channel >= LED_ANIMATOR_MAX_CHANNELS) {
+    return;
+  }
+  tracks[channel].running = false;
+}
+
+void LedAnimator::stopAll() {
+  for (int i = 0; i < LED_ANIMATOR_MAX_CHANNELS; i++) {
+    tracks[i].running = false;
+  }
+}
+
+bool LedAnimator::isRunning(int channel) {
+  if (channel < 0 || channel >= LED_ANIMATOR_MAX_CHANNELS) {
+    return false;
+  }
+  return tracks[channel].running;
+}
+
+/**
+ * run tick() periodically from an event queue (never from an ISR, as the output usually touches the I2C bus)
+ * hz <= 0 is ignored, rates above 1000 are clamped to 1000 (1 ms, the event queue resolution)
+*/
+void LedAnimator::start(int hz, EventQueue *queue /*=mbed_event_queue()*/) {
+  if (hz <= 0) {
+    return;
+  }
+  if (hz > 1000) {
+    hz = 1000;
+  }
+  end();
+  eventQueue = queue;
+  tickEvent = eventQueue->call_every(1000 / hz, callback(this, &LedAnimator::tick));
+}
+
+void LedAnimator::end() {
+  if (eventQueue && tickEvent) {
+    eventQueue->cancel(tickEvent);
+  }
+  tickEvent = 0;
+}
+
+/**
+ * advance every running track by one tick, write the channels whose output changed, then flush once
+*/
+void LedAnimator::tick() {
+  bool changed = false;
+  for (int channel = 0; channel < LED_ANIMATOR_MAX_CHANNELS; channel++) {
+    Track *track = &tracks[channel];
+    if (!track->running) {
+      continue;
+    }
+
+    if (track->remaining > 0) {
+      track->value += track->slope;
+      track->remaining--;
+    }
+
+    if (track->remaining == 0) {
+      track->value = track->keyframes[track->index].value << 8; // land exactly on the keyframe
+      track->index++;
+      if (track->index >= track->count) {
+        if (track->loop) {
+          track->index = 0;
+          loadKeyframe(track);
+        } else {
+          track->running = false;
+        }
+      } else {
+        loadKeyframe(track);
+      }
+    }
+
+    int output = (track->value + 0x80) >> 8;
+    if (output != track->output) {
+      track->output = output;
+      outputCallback(channel, output);
+      changed = true;
+    }
+  }
+
+  if (changed && flushCallback) {
+    flushCallback();
+  }
+}
+
+/**
+ * set up the ramp from the current value to keyframes[index]
+*/
+void LedAnimator::loadKeyframe(Track *track) {
+  Keyframe *keyframe = &track->keyframes[track->index];
+  track->remaining = keyframe->ticks;
+  if (keyframe->ticks == 0) {
+    track->slope = 0;
+  } else {
+    track->slope = ((keyframe->value << 8) - track->value) / keyframe->ticks;
+  }
+}
@@ -0,0 +1,74 @@
+#ifndef __LED_ANIMATOR_H
+#define __LED_ANIMATOR_H
+
+#include "mbed.h"
+
+#define LED_ANIMATOR_MAX_CHANNELS   32
+#define LED_ANIMATOR_MAX_KEYFRAMES  8
+
+/**
+ * Keyframe animation of LED brightness, interpolated with Q8.8 fixed point math on a single periodic tick.
+ * 
+ * Each channel plays a track of keyframes, every keyframe ramping linearly from the previous value to its own
+ * value over a number of ticks. Changed channels are written through the output callback (ideally a buffered
+ * driver write) and the flush callback is called once per tick, so any number of animations cost one tick
+ * handler and one bus burst per frame.
+ * 
+ * ex.  LedAnimator animator(callback(&leds, &TLC59116::bufferLedPWM), callback(&leds, &TLC59116::flush));
+ *      const LedAnimator::Keyframe pulse[2] = { { 30, 255 }, { 30, 0 } };
+ *      animator.setTrack(0, pulse, 2, true);
+ *      animator.start(60);
+*/
+class LedAnimator {
+public:
+
+  struct Keyframe {
+    uint16_t ticks;      // ticks taken to ramp from the previous keyframe to this one (0 == jump)
+    uint8_t value;       // brightness / pwm at the end of the ramp
+  };
+
+  LedAnimator(Callback<void(int, int)> output, Callback<void()> flush = NULL) {
+    outputCallback = output;
+    flushCallback = flush;
+    eventQueue = NULL;
+    tickEvent = 0;
+    for (int i = 0; i < LED_ANIMATOR_MAX_CHANNELS; i++) {
+      tracks[i].running = false;
+      tracks[i].value = 0;
+      tracks[i].output = -1;
+    }
+  };
+
+  void setTrack(int channel, const Keyframe *keyframes, int count, bool loop = false);
+  void stop(int channel);
+  void stopAll();
+  bool isRunning(int channel);
+
+  void start(int hz, EventQueue *queue = mbed_event_queue());
+  void end();
+  void tick();
+
+private:
+
+  struct Track {
+    Keyframe keyframes[LED_ANIMATOR_MAX_KEYFRAMES];
+    uint8_t count;
+    uint8_t index;       // keyframe currently being ramped to
+    uint16_t remaining;  // ticks left in the current ramp
+    bool loop;
+    bool running;
+    int32_t value;       // Q8.8
+    int32_t slope;       // Q8.8 per tick
+    int output;          // last value written, -1 == never
+  };
+
+  void loadKeyframe(Track *track);
+
+  Track tracks[LED_ANIMATOR_MAX_CHANNELS];
+  Callback<void(int, int)> outputCallback;
+  Callback<void()> flushCallback;
+  EventQueue *eventQueue;
+  int tickEvent;
+};
+
+#endif